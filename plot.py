@@ -42,6 +42,8 @@ def metric_str(args):
         return 'Measured Time [s]'
     elif args['metric'].lower() == 'bandwidth':
         return 'Estimated Bandwidth [GB/s]'
+    elif args['metric'].lower() == 'flops':
+        return 'Estimated Performance [GFLOP/s]'
     elif args['metric'].lower() == 'papi':
         return args['papi-event']
     elif args['metric'].lower() == 'papi-imbalance':
@@ -52,6 +54,8 @@ def metric_abbr(args):
         return 'Time'
     elif args['metric'].lower() == 'bandwidth':
         return 'BW'
+    elif args['metric'].lower() == 'flops':
+        return 'FLOPS'
     elif args['metric'].lower() == 'papi':
         return 'CTR'
     elif args['metric'].lower() == 'papi-imbalance':
@@ -135,8 +139,9 @@ def plot_blocksize_scan(args, data, logscale=False, lim=None, viewscale=True):
     y = np.array(data.columns, dtype=int)
     plt.xticks(np.arange(x.size), x)
     plt.yticks(np.arange(y.size), y)
-    plt.xlabel('i-Blocksize')
-    plt.ylabel('j-Blocksize')
+    iarg, jarg = args.get('scan-args', 'i-blocksize,j-blocksize').split(',')
+    plt.xlabel(iarg[:2] + iarg[2:].capitalize())
+    plt.ylabel(jarg[:2] + jarg[2:].capitalize())
     if mul == 1:
         mulstr = ''
     elif mul > 1:
@@ -6,10 +6,24 @@
 #include <random>
 
 #include "except.h"
+#include "multifield_kernel.h"
 #include "variant_base.h"
 
 namespace platform {
 
+    // storage of the source fields: separate arrays, interleaved per element or interleaved per cache line
+    enum class field_layout { soa, aos, aosoa };
+
+    inline field_layout parse_field_layout(const std::string &layout) {
+        if (layout == "soa")
+            return field_layout::soa;
+        if (layout == "aos")
+            return field_layout::aos;
+        if (layout == "aosoa")
+            return field_layout::aosoa;
+        throw ERROR("invalid field layout '" + layout + "'");
+    }
+
     template <class Platform, class ValueType>
     class basic_multifield_variant : public variant_base {
       public:
@@ -17,7 +31,9 @@ namespace platform {
         using value_type = ValueType;
         using allocator = typename platform::template allocator<value_type>;
 
-        basic_multifield_variant(const arguments_map &args);
+        static constexpr int aosoa_width = 64 / sizeof(value_type);
+
+        basic_multifield_variant(const arguments_map &args, field_layout layout = field_layout::soa);
         virtual ~basic_multifield_variant() {}
 
         std::vector<std::string> stencil_list() const override;
@@ -35,9 +51,23 @@ namespace platform {
         virtual void lapij() = 0;
 
       protected:
-        value_type *src(int field) { return m_src_data.at(field).data() + zero_offset(); }
         value_type *dst() { return m_dst_data.data() + zero_offset(); }
-        int fields() const { return m_src_data.size(); }
+        int fields() const { return m_fields; }
+        int fields_per_pass() const { return m_fields_per_pass; }
+        field_layout layout() const { return m_layout; }
+
+        multifield::soa<value_type> soa_fields() const {
+            check_layout(field_layout::soa);
+            return {m_src_ptrs.data()};
+        }
+        multifield::aos<value_type> aos_fields() const {
+            check_layout(field_layout::aos);
+            return {m_src_data.front().data() + std::size_t(zero_offset()) * m_fields, m_fields};
+        }
+        multifield::aosoa<value_type, aosoa_width> aosoa_fields() const {
+            check_layout(field_layout::aosoa);
+            return {m_src_data.front().data() + aosoa_width * m_fields, m_fields, zero_offset()};
+        }
 
         std::function<void()> stencil_function(const std::string &stencil) override;
 
@@ -47,26 +77,56 @@ namespace platform {
         std::size_t bytes_per_element() const override { return sizeof(value_type); }
 
       private:
+        void check_layout(field_layout layout) const {
+            if (m_layout != layout)
+                throw ERROR("field layout mismatch");
+        }
+
+        // element at storage index p (not relative to the zero offset) of a source field
+        value_type &src_element(int field, int p);
+
+        int m_fields;
+        field_layout m_layout;
+        // one array per field for soa, a single interleaved array otherwise
         std::vector<std::vector<value_type, allocator>> m_src_data;
+        std::vector<const value_type *> m_src_ptrs;
         std::vector<value_type, allocator> m_dst_data;
         value_type *m_src, *m_dst;
+        int m_fields_per_pass;
     };
 
     template <class Platform, class ValueType>
-    basic_multifield_variant<Platform, ValueType>::basic_multifield_variant(const arguments_map &args)
-        : variant_base(args), m_src_data(args.get<int>("fields")), m_dst_data(storage_size()) {
-        for (auto &src_data : m_src_data)
-            src_data.resize(storage_size());
+    basic_multifield_variant<Platform, ValueType>::basic_multifield_variant(
+        const arguments_map &args, field_layout layout)
+        : variant_base(args), m_fields(args.get<int>("fields")), m_layout(layout), m_dst_data(storage_size()),
+          m_fields_per_pass(args.get<int>("fields-per-pass")) {
+        if (m_fields <= 0)
+            throw ERROR("invalid number of fields");
+        if (m_fields_per_pass <= 0 || m_fields_per_pass > MULTIFIELD_MAX_FIELDS)
+            throw ERROR("invalid number of fields per pass");
+        if (m_layout == field_layout::soa) {
+            m_src_data.resize(m_fields);
+            for (auto &src_data : m_src_data) {
+                src_data.resize(storage_size());
+                m_src_ptrs.push_back(src_data.data() + zero_offset());
+            }
+        } else {
+            // aosoa: one padding block before and after the data, see multifield::aosoa
+            const int blocks = (storage_size() + aosoa_width - 1) / aosoa_width + 2;
+            const int elements = m_layout == field_layout::aos ? storage_size() : blocks * aosoa_width;
+            m_src_data.resize(1);
+            m_src_data.front().resize(std::size_t(elements) * m_fields);
+        }
 #pragma omp parallel
         {
             std::minstd_rand eng;
             std::uniform_real_distribution<value_type> dist(-100, 100);
 
             int total_size = storage_size();
-            for (auto &src_data : m_src_data) {
+            for (int field = 0; field < m_fields; ++field) {
 #pragma omp for
                 for (int i = 0; i < total_size; ++i)
-                    src_data.at(i) = dist(eng);
+                    src_element(field, i) = dist(eng);
             }
 #pragma omp for
             for (int i = 0; i < total_size; ++i)
@@ -74,6 +134,16 @@ namespace platform {
         }
     }
 
+    template <class Platform, class ValueType>
+    ValueType &basic_multifield_variant<Platform, ValueType>::src_element(int field, int p) {
+        if (m_layout == field_layout::soa)
+            return m_src_data.at(field).at(p);
+        if (m_layout == field_layout::aos)
+            return m_src_data.front().at(std::size_t(p) * m_fields + field);
+        return m_src_data.front().at(
+            std::size_t(p / aosoa_width + 1) * aosoa_width * m_fields + field * aosoa_width + p % aosoa_width);
+    }
+
     template <class Platform, class ValueType>
     std::vector<std::string> basic_multifield_variant<Platform, ValueType>::stencil_list() const {
         return {"copy", "copyi", "copyj", "copyk", "avgi", "avgj", "avgk", "sumi", "sumj", "sumk", "lapij"};
@@ -111,41 +181,59 @@ namespace platform {
         std::function<bool(int, int, int)> f;
         auto s = [&](int i, int j, int k) {
             value_type sum = 0;
-            for (const auto &src_data : m_src_data)
-                sum += (src_data.data() + zero_offset())[index(i, j, k)];
+            for (int field = 0; field < m_fields; ++field)
+                sum += src_element(field, zero_offset() + index(i, j, k));
+            return sum;
+        };
+        // sum of magnitudes, results may cancel out, so the tolerance is relative to the summed terms
+        auto a = [&](int i, int j, int k) {
+            value_type sum = 0;
+            for (int field = 0; field < m_fields; ++field)
+                sum += std::abs(src_element(field, zero_offset() + index(i, j, k)));
             return sum;
         };
         auto d = [&](int i, int j, int k) { return (m_dst_data.data() + zero_offset())[index(i, j, k)]; };
-        auto eq = [](value_type a, value_type b) {
-            value_type diff = std::abs(a - b);
-            a = std::abs(a);
-            b = std::abs(b);
-            return diff <= (a > b ? a : b) * 1e-3;
+        auto eq = [](value_type result, value_type reference, value_type magnitude) {
+            return std::abs(result - reference) <= magnitude * 1e-3;
         };
 
         if (stencil == "copy") {
-            f = [&](int i, int j, int k) { return eq(d(i, j, k), s(i, j, k)); };
+            f = [&](int i, int j, int k) { return eq(d(i, j, k), s(i, j, k), a(i, j, k)); };
         } else if (stencil == "copyi") {
-            f = [&](int i, int j, int k) { return eq(d(i, j, k), s(i + 1, j, k)); };
+            f = [&](int i, int j, int k) { return eq(d(i, j, k), s(i + 1, j, k), a(i + 1, j, k)); };
         } else if (stencil == "copyj") {
-            f = [&](int i, int j, int k) { return eq(d(i, j, k), s(i, j + 1, k)); };
+            f = [&](int i, int j, int k) { return eq(d(i, j, k), s(i, j + 1, k), a(i, j + 1, k)); };
         } else if (stencil == "copyk") {
-            f = [&](int i, int j, int k) { return eq(d(i, j, k), s(i, j, k + 1)); };
+            f = [&](int i, int j, int k) { return eq(d(i, j, k), s(i, j, k + 1), a(i, j, k + 1)); };
         } else if (stencil == "avgi") {
-            f = [&](int i, int j, int k) { return eq(d(i, j, k), s(i - 1, j, k) + s(i + 1, j, k)); };
+            f = [&](int i, int j, int k) {
+                return eq(d(i, j, k), s(i - 1, j, k) + s(i + 1, j, k), a(i - 1, j, k) + a(i + 1, j, k));
+            };
         } else if (stencil == "avgj") {
-            f = [&](int i, int j, int k) { return eq(d(i, j, k), s(i, j - 1, k) + s(i, j + 1, k)); };
+            f = [&](int i, int j, int k) {
+                return eq(d(i, j, k), s(i, j - 1, k) + s(i, j + 1, k), a(i, j - 1, k) + a(i, j + 1, k));
+            };
         } else if (stencil == "avgk") {
-            f = [&](int i, int j, int k) { return eq(d(i, j, k), s(i, j, k - 1) + s(i, j, k + 1)); };
+            f = [&](int i, int j, int k) {
+                return eq(d(i, j, k), s(i, j, k - 1) + s(i, j, k + 1), a(i, j, k - 1) + a(i, j, k + 1));
+            };
         } else if (stencil == "sumi") {
-            f = [&](int i, int j, int k) { return eq(d(i, j, k), s(i, j, k) + s(i + 1, j, k)); };
+            f = [&](int i, int j, int k) {
+                return eq(d(i, j, k), s(i, j, k) + s(i + 1, j, k), a(i, j, k) + a(i + 1, j, k));
+            };
         } else if (stencil == "sumj") {
-            f = [&](int i, int j, int k) { return eq(d(i, j, k), s(i, j, k) + s(i, j + 1, k)); };
+            f = [&](int i, int j, int k) {
+                return eq(d(i, j, k), s(i, j, k) + s(i, j + 1, k), a(i, j, k) + a(i, j + 1, k));
+            };
         } else if (stencil == "sumk") {
-            f = [&](int i, int j, int k) { return eq(d(i, j, k), s(i, j, k) + s(i, j, k + 1)); };
+            f = [&](int i, int j, int k) {
+                return eq(d(i, j, k), s(i, j, k) + s(i, j, k + 1), a(i, j, k) + a(i, j, k + 1));
+            };
         } else if (stencil == "lapij") {
             f = [&](int i, int j, int k) {
-                return eq(d(i, j, k), s(i, j, k) + s(i - 1, j, k) + s(i + 1, j, k) + s(i, j - 1, k) + s(i, j + 1, k));
+                return eq(d(i, j, k),
+                    s(i, j, k) + s(i - 1, j, k) + s(i + 1, j, k) + s(i, j - 1, k) + s(i, j + 1, k),
+                    a(i, j, k) + a(i - 1, j, k) + a(i + 1, j, k) + a(i, j - 1, k) + a(i, j + 1, k));
             };
         } else {
             throw ERROR("unknown stencil '" + stencil + "'");
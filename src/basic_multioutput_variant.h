@@ -0,0 +1,210 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include "except.h"
+#include "multifield_kernel.h"
+#include "variant_base.h"
+
+namespace platform {
+
+    // reads fields-in source fields and writes fields-out destination fields, destination m is (m + 1) times
+    // the stencil applied to the sum of all sources, so all outputs share the same reads
+    template <class Platform, class ValueType>
+    class basic_multioutput_variant : public variant_base {
+      public:
+        using platform = Platform;
+        using value_type = ValueType;
+        using allocator = typename platform::template allocator<value_type>;
+
+        basic_multioutput_variant(const arguments_map &args);
+        virtual ~basic_multioutput_variant() {}
+
+        std::vector<std::string> stencil_list() const override;
+
+        virtual void copy() = 0;
+        virtual void avgi() = 0;
+        virtual void avgj() = 0;
+        virtual void avgk() = 0;
+        virtual void lapij() = 0;
+
+      protected:
+        value_type *dst(int field) { return m_dst_data.at(field).data() + zero_offset(); }
+        std::vector<value_type *> dst_pointers() {
+            std::vector<value_type *> ptrs;
+            for (int field = 0; field < fields_out(); ++field)
+                ptrs.push_back(dst(field));
+            return ptrs;
+        }
+        int fields_in() const { return m_src_data.size(); }
+        int fields_out() const { return m_dst_data.size(); }
+        int fields_per_pass() const { return m_fields_per_pass; }
+        multifield::soa<value_type> src_fields() const { return {m_src_ptrs.data()}; }
+
+        // writes (m + 1) * values[l] to dst[m][first + l] for all outputs m and l < n, or adds it if accumulate is set
+        static void store_outputs(value_type *const *dst, int fields_out, const value_type *values, int first, int n,
+            bool accumulate) {
+            for (int m = 0; m < fields_out; ++m) {
+                value_type *__restrict__ d = dst[m] + first;
+                const value_type w = m + 1;
+                if (accumulate) {
+#pragma omp simd
+                    for (int l = 0; l < n; ++l)
+                        d[l] += w * values[l];
+                } else {
+#pragma omp simd
+                    for (int l = 0; l < n; ++l)
+                        d[l] = w * values[l];
+                }
+            }
+        }
+
+        std::function<void()> stencil_function(const std::string &stencil) override;
+
+        bool verify(const std::string &stencil) override;
+
+        std::size_t touched_elements(const std::string &stencil) const override;
+        std::size_t bytes_per_element() const override { return sizeof(value_type); }
+
+      private:
+        std::vector<std::vector<value_type, allocator>> m_src_data, m_dst_data;
+        std::vector<const value_type *> m_src_ptrs;
+        int m_fields_per_pass;
+    };
+
+    template <class Platform, class ValueType>
+    basic_multioutput_variant<Platform, ValueType>::basic_multioutput_variant(const arguments_map &args)
+        : variant_base(args), m_src_data(args.get<int>("fields-in")), m_dst_data(args.get<int>("fields-out")),
+          m_fields_per_pass(args.get<int>("fields-per-pass")) {
+        if (m_src_data.empty() || m_dst_data.empty())
+            throw ERROR("invalid number of fields");
+        if (m_fields_per_pass <= 0 || m_fields_per_pass > MULTIFIELD_MAX_FIELDS)
+            throw ERROR("invalid number of fields per pass");
+        for (auto &src_data : m_src_data) {
+            src_data.resize(storage_size());
+            m_src_ptrs.push_back(src_data.data() + zero_offset());
+        }
+        for (auto &dst_data : m_dst_data)
+            dst_data.resize(storage_size());
+#pragma omp parallel
+        {
+            std::minstd_rand eng;
+            std::uniform_real_distribution<value_type> dist(-100, 100);
+
+            int total_size = storage_size();
+            for (auto &src_data : m_src_data) {
+#pragma omp for
+                for (int i = 0; i < total_size; ++i)
+                    src_data.at(i) = dist(eng);
+            }
+            for (auto &dst_data : m_dst_data) {
+#pragma omp for
+                for (int i = 0; i < total_size; ++i)
+                    dst_data.at(i) = dist(eng);
+            }
+        }
+    }
+
+    template <class Platform, class ValueType>
+    std::vector<std::string> basic_multioutput_variant<Platform, ValueType>::stencil_list() const {
+        return {"copy", "avgi", "avgj", "avgk", "lapij"};
+    }
+
+    template <class Platform, class ValueType>
+    std::function<void()> basic_multioutput_variant<Platform, ValueType>::stencil_function(
+        const std::string &stencil) {
+        if (stencil == "copy")
+            return std::bind(&basic_multioutput_variant::copy, this);
+        if (stencil == "avgi")
+            return std::bind(&basic_multioutput_variant::avgi, this);
+        if (stencil == "avgj")
+            return std::bind(&basic_multioutput_variant::avgj, this);
+        if (stencil == "avgk")
+            return std::bind(&basic_multioutput_variant::avgk, this);
+        if (stencil == "lapij")
+            return std::bind(&basic_multioutput_variant::lapij, this);
+        throw ERROR("unknown stencil '" + stencil + "'");
+    }
+
+    template <class Platform, class ValueType>
+    bool basic_multioutput_variant<Platform, ValueType>::verify(const std::string &stencil) {
+        // sum over all sources and sum of magnitudes, the tolerance is relative to the summed terms
+        auto s = [&](int i, int j, int k) {
+            value_type sum = 0;
+            for (const auto &src_data : m_src_data)
+                sum += (src_data.data() + zero_offset())[index(i, j, k)];
+            return sum;
+        };
+        auto a = [&](int i, int j, int k) {
+            value_type sum = 0;
+            for (const auto &src_data : m_src_data)
+                sum += std::abs((src_data.data() + zero_offset())[index(i, j, k)]);
+            return sum;
+        };
+
+        // reference value and magnitude of the stencil applied to the sum of all sources
+        std::function<std::pair<value_type, value_type>(int, int, int)> f;
+        if (stencil == "copy") {
+            f = [&](int i, int j, int k) { return std::make_pair(s(i, j, k), a(i, j, k)); };
+        } else if (stencil == "avgi") {
+            f = [&](int i, int j, int k) {
+                return std::make_pair(s(i - 1, j, k) + s(i + 1, j, k), a(i - 1, j, k) + a(i + 1, j, k));
+            };
+        } else if (stencil == "avgj") {
+            f = [&](int i, int j, int k) {
+                return std::make_pair(s(i, j - 1, k) + s(i, j + 1, k), a(i, j - 1, k) + a(i, j + 1, k));
+            };
+        } else if (stencil == "avgk") {
+            f = [&](int i, int j, int k) {
+                return std::make_pair(s(i, j, k - 1) + s(i, j, k + 1), a(i, j, k - 1) + a(i, j, k + 1));
+            };
+        } else if (stencil == "lapij") {
+            f = [&](int i, int j, int k) {
+                return std::make_pair(
+                    s(i, j, k) + s(i - 1, j, k) + s(i + 1, j, k) + s(i, j - 1, k) + s(i, j + 1, k),
+                    a(i, j, k) + a(i - 1, j, k) + a(i + 1, j, k) + a(i, j - 1, k) + a(i, j + 1, k));
+            };
+        } else {
+            throw ERROR("unknown stencil '" + stencil + "'");
+        }
+
+        const int isize = this->isize();
+        const int jsize = this->jsize();
+        const int ksize = this->ksize();
+        const int fields_out = this->fields_out();
+        bool success = true;
+#pragma omp parallel for collapse(3) reduction(&& : success)
+        for (int k = 0; k < ksize; ++k)
+            for (int j = 0; j < jsize; ++j)
+                for (int i = 0; i < isize; ++i) {
+                    const auto ref = f(i, j, k);
+                    for (int m = 0; m < fields_out; ++m) {
+                        const value_type d = (m_dst_data[m].data() + zero_offset())[index(i, j, k)];
+                        success = success && std::abs(d - (m + 1) * ref.first) <= (m + 1) * ref.second * 1e-3;
+                    }
+                }
+        return success;
+    }
+
+    template <class Platform, class ValueType>
+    std::size_t basic_multioutput_variant<Platform, ValueType>::touched_elements(const std::string &stencil) const {
+        std::size_t i = isize();
+        std::size_t j = jsize();
+        std::size_t k = ksize();
+        std::size_t writes = i * j * k * fields_out();
+        if (stencil == "copy")
+            return writes + i * j * k * fields_in();
+        if (stencil == "avgi")
+            return writes + (i + 2) * j * k * fields_in();
+        if (stencil == "avgj")
+            return writes + i * (j + 2) * k * fields_in();
+        if (stencil == "avgk")
+            return writes + i * j * (k + 2) * fields_in();
+        if (stencil == "lapij")
+            return writes + (i + 2) * (j + 2) * k * fields_in();
+        throw ERROR("unknown stencil '" + stencil + "'");
+    }
+
+} // platform
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "except.h"
+
+#ifdef __CUDACC__
+#define BASIC_STENCIL_FUNCTION __host__ __device__ __forceinline__
+#else
+#define BASIC_STENCIL_FUNCTION inline
+#endif
+
+// defines a basic stencil with the given name and terms
+#define BASIC_STENCIL(stencil_name, ...)                     \
+    struct stencil_name : terms<__VA_ARGS__> {               \
+        static const char *name() { return #stencil_name; } \
+    }
+
+namespace platform {
+
+    // compile-time description of the basic stencils: a stencil is a weighted sum of src values at constant
+    // offsets, dst(i, j, k) = sum of coeff * src(i + di, j + dj, k + dk) over its terms; the kernels of all
+    // loop schedules, the reference verification, touched elements and flop counts are derived from the terms
+    namespace basic_stencil {
+
+        template <int DI, int DJ, int DK, int Coeff = 1>
+        struct term {
+            static constexpr int di = DI, dj = DJ, dk = DK, coeff = Coeff;
+
+            template <class T>
+            static BASIC_STENCIL_FUNCTION T value(
+                const T *__restrict__ src, const int istride, const int jstride, const int kstride) {
+                return Coeff == 1 ? src[DI * istride + DJ * jstride + DK * kstride]
+                                  : T(Coeff) * src[DI * istride + DJ * jstride + DK * kstride];
+            }
+        };
+
+        constexpr int min(const int a, const int b) { return a < b ? a : b; }
+        constexpr int max(const int a, const int b) { return a > b ? a : b; }
+
+        template <class... Terms>
+        struct terms;
+
+        template <class Term>
+        struct terms<Term> {
+            // bounding box of the offsets
+            static constexpr int imin = Term::di, imax = Term::di;
+            static constexpr int jmin = Term::dj, jmax = Term::dj;
+            static constexpr int kmin = Term::dk, kmax = Term::dk;
+            // additions and multiplications per point
+            static constexpr int flops = Term::coeff == 1 ? 0 : 1;
+
+            template <class T>
+            static BASIC_STENCIL_FUNCTION T accumulate(
+                const T sum, const T *__restrict__ src, const int istride, const int jstride, const int kstride) {
+                return sum + Term::value(src, istride, jstride, kstride);
+            }
+
+            // value of the stencil at src, summed up from left to right so that all kernels and the reference
+            // give bitwise identical results
+            template <class T>
+            static BASIC_STENCIL_FUNCTION T eval(
+                const T *__restrict__ src, const int istride, const int jstride, const int kstride) {
+                return Term::value(src, istride, jstride, kstride);
+            }
+        };
+
+        template <class Term, class... Rest>
+        struct terms<Term, Rest...> {
+            static constexpr int imin = min(Term::di, terms<Rest...>::imin), imax = max(Term::di, terms<Rest...>::imax);
+            static constexpr int jmin = min(Term::dj, terms<Rest...>::jmin), jmax = max(Term::dj, terms<Rest...>::jmax);
+            static constexpr int kmin = min(Term::dk, terms<Rest...>::kmin), kmax = max(Term::dk, terms<Rest...>::kmax);
+            static constexpr int flops = terms<Term>::flops + 1 + terms<Rest...>::flops;
+
+            template <class T>
+            static BASIC_STENCIL_FUNCTION T accumulate(
+                const T sum, const T *__restrict__ src, const int istride, const int jstride, const int kstride) {
+                return terms<Rest...>::accumulate(
+                    sum + Term::value(src, istride, jstride, kstride), src, istride, jstride, kstride);
+            }
+
+            template <class T>
+            static BASIC_STENCIL_FUNCTION T eval(
+                const T *__restrict__ src, const int istride, const int jstride, const int kstride) {
+                return terms<Rest...>::accumulate(
+                    Term::value(src, istride, jstride, kstride), src, istride, jstride, kstride);
+            }
+        };
+
+        BASIC_STENCIL(copy, term<0, 0, 0>);
+        BASIC_STENCIL(copyi, term<1, 0, 0>);
+        BASIC_STENCIL(copyj, term<0, 1, 0>);
+        BASIC_STENCIL(copyk, term<0, 0, 1>);
+        BASIC_STENCIL(avgi, term<-1, 0, 0>, term<1, 0, 0>);
+        BASIC_STENCIL(avgj, term<0, -1, 0>, term<0, 1, 0>);
+        BASIC_STENCIL(avgk, term<0, 0, -1>, term<0, 0, 1>);
+        BASIC_STENCIL(sumi, term<0, 0, 0>, term<1, 0, 0>);
+        BASIC_STENCIL(sumj, term<0, 0, 0>, term<0, 1, 0>);
+        BASIC_STENCIL(sumk, term<0, 0, 0>, term<0, 0, 1>);
+        BASIC_STENCIL(lapij, term<0, 0, 0>, term<-1, 0, 0>, term<1, 0, 0>, term<0, -1, 0>, term<0, 1, 0>);
+
+        template <class... Stencils>
+        struct list {};
+
+        // all basic stencils, in the order in which they are run
+        using stencils = list<copy, copyi, copyj, copyk, avgi, avgj, avgk, sumi, sumj, sumk, lapij>;
+
+        template <class... Stencils>
+        std::vector<std::string> names(list<Stencils...>) {
+            return {Stencils::name()...};
+        }
+
+        // calls f.template apply<Stencil>() for the stencil with the given name
+        template <class F>
+        void dispatch(list<>, const std::string &stencil, F &) {
+            throw ERROR("unknown stencil '" + stencil + "'");
+        }
+
+        template <class Stencil, class... Rest, class F>
+        void dispatch(list<Stencil, Rest...>, const std::string &stencil, F &f) {
+            if (stencil == Stencil::name())
+                f.template apply<Stencil>();
+            else
+                dispatch(list<Rest...>(), stencil, f);
+        }
+
+        template <class Variant>
+        struct kernel_binder {
+            template <class Stencil>
+            void apply() {
+                Variant *v = variant;
+                function = [v]() { v->template kernel<Stencil>(); };
+            }
+
+            Variant *variant;
+            std::function<void()> function;
+        };
+
+        // function running variant->kernel<Stencil>() for the stencil with the given name
+        template <class Variant>
+        std::function<void()> kernel_function(Variant *variant, const std::string &stencil) {
+            kernel_binder<Variant> binder{variant, nullptr};
+            dispatch(stencils(), stencil, binder);
+            return binder.function;
+        }
+
+    } // namespace basic_stencil
+
+} // namespace platform
+
+#undef BASIC_STENCIL
@@ -1,10 +1,15 @@
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
+#include <memory>
 #include <random>
 
+#include "basic_stencil.h"
 #include "except.h"
+#include "jit.h"
+#include "stencil_expr.h"
 #include "variant_base.h"
 
 namespace platform {
@@ -21,37 +26,54 @@ namespace platform {
 
         std::vector<std::string> stencil_list() const override;
 
-        virtual void copy() = 0;
-        virtual void copyi() = 0;
-        virtual void copyj() = 0;
-        virtual void copyk() = 0;
-        virtual void avgi() = 0;
-        virtual void avgj() = 0;
-        virtual void avgk() = 0;
-        virtual void sumi() = 0;
-        virtual void sumj() = 0;
-        virtual void sumk() = 0;
-        virtual void lapij() = 0;
-
       protected:
         value_type *src() { return m_src_data.data() + zero_offset(); }
         value_type *dst() { return m_dst_data.data() + zero_offset(); }
 
-        std::function<void()> stencil_function(const std::string &stencil) override;
+        // function running variant->kernel<Stencil>() for the given stencil; for stencil "expr", Stencil is
+        // generated from --stencil-expr and the kernel is JIT-compiled from header, the header defining Variant
+        template <class Variant>
+        std::function<void()> kernel_function(Variant *variant, const std::string &stencil, const std::string &header);
+
+        // JIT-compiled function running variant->kernel<Stencil, kernel_args>() for the given stencil, kernel_args
+        // are C++ template arguments, starting with a comma
+        template <class Variant>
+        std::function<void()> jit_kernel_function(Variant *variant,
+            const std::string &stencil,
+            const std::string &header,
+            const std::string &kernel_args);
 
         bool verify(const std::string &stencil) override;
 
         std::size_t touched_elements(const std::string &stencil) const override;
+        std::size_t flops(const std::string &stencil) const override;
         std::size_t bytes_per_element() const override { return sizeof(value_type); }
 
       private:
+        struct verifier;
+        struct element_counter;
+        struct flop_counter;
+
+        // checks dst against eval(src + index, istride, jstride, kstride) on the whole domain
+        template <class Eval>
+        bool verify_with(const Eval &eval) const;
+
+        std::size_t touched_elements(int imin, int imax, int jmin, int jmax, int kmin, int kmax) const;
+
+        std::unique_ptr<stencil_expr> m_expr;
+        jit::options m_jit;
         std::vector<value_type, allocator> m_src_data, m_dst_data;
         value_type *m_src, *m_dst;
     };
 
     template <class Platform, class ValueType>
     basic_stencil_variant<Platform, ValueType>::basic_stencil_variant(const arguments_map &args)
-        : variant_base(args), m_src_data(storage_size()), m_dst_data(storage_size()) {
+        : variant_base(args),
+          m_expr(args.get("stencil-expr").empty() ? nullptr : new stencil_expr(args.get("stencil-expr"))), m_jit(args),
+          m_src_data(storage_size()), m_dst_data(storage_size()) {
+        if (m_expr && (-m_expr->imin() > halo() || m_expr->imax() > halo() || -m_expr->jmin() > halo() ||
+                          m_expr->jmax() > halo() || -m_expr->kmin() > halo() || m_expr->kmax() > halo()))
+            throw ERROR("offsets of stencil expression exceed halo size");
 #pragma omp parallel
         {
             std::minstd_rand eng;
@@ -68,104 +90,143 @@ namespace platform {
 
     template <class Platform, class ValueType>
     std::vector<std::string> basic_stencil_variant<Platform, ValueType>::stencil_list() const {
-        return {"copy", "copyi", "copyj", "copyk", "avgi", "avgj", "avgk", "sumi", "sumj", "sumk", "lapij"};
+        std::vector<std::string> list = basic_stencil::names(basic_stencil::stencils());
+        if (m_expr)
+            list.push_back("expr");
+        return list;
     }
 
     template <class Platform, class ValueType>
-    std::function<void()> basic_stencil_variant<Platform, ValueType>::stencil_function(const std::string &stencil) {
-        if (stencil == "copy")
-            return std::bind(&basic_stencil_variant::copy, this);
-        if (stencil == "copyi")
-            return std::bind(&basic_stencil_variant::copyi, this);
-        if (stencil == "copyj")
-            return std::bind(&basic_stencil_variant::copyj, this);
-        if (stencil == "copyk")
-            return std::bind(&basic_stencil_variant::copyk, this);
-        if (stencil == "avgi")
-            return std::bind(&basic_stencil_variant::avgi, this);
-        if (stencil == "avgj")
-            return std::bind(&basic_stencil_variant::avgj, this);
-        if (stencil == "avgk")
-            return std::bind(&basic_stencil_variant::avgk, this);
-        if (stencil == "sumi")
-            return std::bind(&basic_stencil_variant::sumi, this);
-        if (stencil == "sumj")
-            return std::bind(&basic_stencil_variant::sumj, this);
-        if (stencil == "sumk")
-            return std::bind(&basic_stencil_variant::sumk, this);
-        if (stencil == "lapij")
-            return std::bind(&basic_stencil_variant::lapij, this);
-        throw ERROR("unknown stencil '" + stencil + "'");
+    template <class Variant>
+    std::function<void()> basic_stencil_variant<Platform, ValueType>::kernel_function(
+        Variant *variant, const std::string &stencil, const std::string &header) {
+        if (stencil != "expr" || !m_expr)
+            return basic_stencil::kernel_function(variant, stencil);
+        return jit_kernel_function(variant, stencil, header, "");
     }
 
     template <class Platform, class ValueType>
-    bool basic_stencil_variant<Platform, ValueType>::verify(const std::string &stencil) {
-        std::function<bool(int, int, int)> f;
-        auto s = [&](int i, int j, int k) { return (m_src_data.data() + zero_offset())[index(i, j, k)]; };
-        auto d = [&](int i, int j, int k) { return (m_dst_data.data() + zero_offset())[index(i, j, k)]; };
-
-        if (stencil == "copy") {
-            f = [&](int i, int j, int k) { return d(i, j, k) == s(i, j, k); };
-        } else if (stencil == "copyi") {
-            f = [&](int i, int j, int k) { return d(i, j, k) == s(i + 1, j, k); };
-        } else if (stencil == "copyj") {
-            f = [&](int i, int j, int k) { return d(i, j, k) == s(i, j + 1, k); };
-        } else if (stencil == "copyk") {
-            f = [&](int i, int j, int k) { return d(i, j, k) == s(i, j, k + 1); };
-        } else if (stencil == "avgi") {
-            f = [&](int i, int j, int k) { return d(i, j, k) == s(i - 1, j, k) + s(i + 1, j, k); };
-        } else if (stencil == "avgj") {
-            f = [&](int i, int j, int k) { return d(i, j, k) == s(i, j - 1, k) + s(i, j + 1, k); };
-        } else if (stencil == "avgk") {
-            f = [&](int i, int j, int k) { return d(i, j, k) == s(i, j, k - 1) + s(i, j, k + 1); };
-        } else if (stencil == "sumi") {
-            f = [&](int i, int j, int k) { return d(i, j, k) == s(i, j, k) + s(i + 1, j, k); };
-        } else if (stencil == "sumj") {
-            f = [&](int i, int j, int k) { return d(i, j, k) == s(i, j, k) + s(i, j + 1, k); };
-        } else if (stencil == "sumk") {
-            f = [&](int i, int j, int k) { return d(i, j, k) == s(i, j, k) + s(i, j, k + 1); };
-        } else if (stencil == "lapij") {
-            f = [&](int i, int j, int k) {
-                return d(i, j, k) == s(i, j, k) + s(i - 1, j, k) + s(i + 1, j, k) + s(i, j - 1, k) + s(i, j + 1, k);
-            };
+    template <class Variant>
+    std::function<void()> basic_stencil_variant<Platform, ValueType>::jit_kernel_function(Variant *variant,
+        const std::string &stencil,
+        const std::string &header,
+        const std::string &kernel_args) {
+        std::string source, stencil_type;
+        if (stencil == "expr" && m_expr) {
+            source = m_expr->source("expr") + "\n";
+            stencil_type = "expr";
         } else {
-            throw ERROR("unknown stencil '" + stencil + "'");
+            const auto names = basic_stencil::names(basic_stencil::stencils());
+            if (std::find(names.begin(), names.end(), stencil) == names.end())
+                throw ERROR("unknown stencil '" + stencil + "'");
+            stencil_type = "platform::basic_stencil::" + stencil;
         }
+        source += "extern \"C\" void stencil_bench_kernel(void *variant) {\n"
+                  "    static_cast<" +
+                  jit::type_name(typeid(Variant)) + " *>(variant)->template kernel<" + stencil_type + kernel_args +
+                  ">();\n"
+                  "}\n";
+        auto kernel = reinterpret_cast<void (*)(void *)>(jit::compile(m_jit, {header}, source, "stencil_bench_kernel"));
+        return [kernel, variant]() { kernel(variant); };
+    }
 
+    template <class Platform, class ValueType>
+    template <class Eval>
+    bool basic_stencil_variant<Platform, ValueType>::verify_with(const Eval &eval) const {
+        const value_type *src = m_src_data.data() + zero_offset();
+        const value_type *dst = m_dst_data.data() + zero_offset();
         const int isize = this->isize();
         const int jsize = this->jsize();
         const int ksize = this->ksize();
+        const int istride = this->istride();
+        const int jstride = this->jstride();
+        const int kstride = this->kstride();
         bool success = true;
 #pragma omp parallel for collapse(3) reduction(&& : success)
         for (int k = 0; k < ksize; ++k)
             for (int j = 0; j < jsize; ++j)
-                for (int i = 0; i < isize; ++i)
-                    success = success && f(i, j, k);
+                for (int i = 0; i < isize; ++i) {
+                    const int idx = index(i, j, k);
+                    success = success && dst[idx] == eval(src + idx, istride, jstride, kstride);
+                }
         return success;
     }
 
+    // dst plus the bounding box of all src reads
+    template <class Platform, class ValueType>
+    std::size_t basic_stencil_variant<Platform, ValueType>::touched_elements(
+        int imin, int imax, int jmin, int jmax, int kmin, int kmax) const {
+        const std::size_t i = isize(), j = jsize(), k = ksize();
+        return i * j * k + (i + imax - imin) * (j + jmax - jmin) * (k + kmax - kmin);
+    }
+
+    // functors for basic_stencil::dispatch
+    template <class Platform, class ValueType>
+    struct basic_stencil_variant<Platform, ValueType>::verifier {
+        template <class Stencil>
+        void apply() {
+            success = v->verify_with([](const value_type *src, int istride, int jstride, int kstride) {
+                return Stencil::eval(src, istride, jstride, kstride);
+            });
+        }
+
+        const basic_stencil_variant *v;
+        bool success;
+    };
+
+    template <class Platform, class ValueType>
+    struct basic_stencil_variant<Platform, ValueType>::element_counter {
+        template <class Stencil>
+        void apply() {
+            elements = v->touched_elements(
+                Stencil::imin, Stencil::imax, Stencil::jmin, Stencil::jmax, Stencil::kmin, Stencil::kmax);
+        }
+
+        const basic_stencil_variant *v;
+        std::size_t elements;
+    };
+
+    template <class Platform, class ValueType>
+    struct basic_stencil_variant<Platform, ValueType>::flop_counter {
+        template <class Stencil>
+        void apply() {
+            flops = std::size_t(v->isize()) * v->jsize() * v->ksize() * Stencil::flops;
+        }
+
+        const basic_stencil_variant *v;
+        std::size_t flops;
+    };
+
+    template <class Platform, class ValueType>
+    bool basic_stencil_variant<Platform, ValueType>::verify(const std::string &stencil) {
+        if (stencil == "expr" && m_expr) {
+            const stencil_expr &expr = *m_expr;
+            return verify_with([&expr](const value_type *src, int istride, int jstride, int kstride) {
+                return expr.eval(src, istride, jstride, kstride);
+            });
+        }
+        verifier f{this, false};
+        basic_stencil::dispatch(basic_stencil::stencils(), stencil, f);
+        return f.success;
+    }
+
     template <class Platform, class ValueType>
     std::size_t basic_stencil_variant<Platform, ValueType>::touched_elements(const std::string &stencil) const {
-        std::size_t i = isize();
-        std::size_t j = jsize();
-        std::size_t k = ksize();
-        if (stencil == "copy" || stencil == "copyi" || stencil == "copyj" || stencil == "copyk")
-            return i * j * k * 2;
-        if (stencil == "avgi")
-            return i * j * k + (i + 2) * j * k;
-        if (stencil == "avgj")
-            return i * j * k + i * (j + 2) * k;
-        if (stencil == "avgk")
-            return i * j * k + i * j * (k + 2);
-        if (stencil == "sumi")
-            return i * j * k + (i + 1) * j * k;
-        if (stencil == "sumj")
-            return i * j * k + i * (j + 1) * k;
-        if (stencil == "sumk")
-            return i * j * k + i * j * (k + 1);
-        if (stencil == "lapij")
-            return i * j * k + (i + 2) * (j + 2) * (k + 2);
-        throw ERROR("unknown stencil '" + stencil + "'");
+        if (stencil == "expr" && m_expr)
+            return touched_elements(
+                m_expr->imin(), m_expr->imax(), m_expr->jmin(), m_expr->jmax(), m_expr->kmin(), m_expr->kmax());
+        element_counter f{this, 0};
+        basic_stencil::dispatch(basic_stencil::stencils(), stencil, f);
+        return f.elements;
+    }
+
+    template <class Platform, class ValueType>
+    std::size_t basic_stencil_variant<Platform, ValueType>::flops(const std::string &stencil) const {
+        if (stencil == "expr" && m_expr)
+            return std::size_t(isize()) * jsize() * ksize() * m_expr->flops();
+        flop_counter f{this, 0};
+        basic_stencil::dispatch(basic_stencil::stencils(), stencil, f);
+        return f.flops;
     }
 
 } // platform
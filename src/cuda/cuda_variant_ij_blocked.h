@@ -6,57 +6,26 @@ namespace platform {
 
     namespace cuda {
 
-#define LOAD(x) x
-
-#define KERNEL(name, stmt)                                     \
-    template <class ValueType>                                 \
-    __global__ void kernel_##name(ValueType *__restrict__ dst, \
-        const ValueType *__restrict__ src,                     \
-        int isize,                                             \
-        int jsize,                                             \
-        int ksize,                                             \
-        int istride,                                           \
-        int jstride,                                           \
-        int kstride) {                                         \
-        const int i = blockIdx.x * blockDim.x + threadIdx.x;   \
-        const int j = blockIdx.y * blockDim.y + threadIdx.y;   \
-                                                               \
-        int idx = i * istride + j * jstride;                   \
-        for (int k = 0; k < ksize; ++k) {                      \
-            if (i < isize && j < jsize) {                      \
-                stmt;                                          \
-                idx += kstride;                                \
-            }                                                  \
-        }                                                      \
-    }
-
-        KERNEL(copy, dst[idx] = LOAD(src[idx]))
-        KERNEL(copyi, dst[idx] = LOAD(src[idx + istride]))
-        KERNEL(copyj, dst[idx] = LOAD(src[idx + jstride]))
-        KERNEL(copyk, dst[idx] = LOAD(src[idx + kstride]))
-        KERNEL(avgi, dst[idx] = LOAD(src[idx - istride]) + LOAD(src[idx + istride]))
-        KERNEL(avgj, dst[idx] = LOAD(src[idx - jstride]) + LOAD(src[idx + jstride]))
-        KERNEL(avgk, dst[idx] = LOAD(src[idx - kstride]) + LOAD(src[idx + kstride]))
-        KERNEL(sumi, dst[idx] = LOAD(src[idx]) + LOAD(src[idx + istride]))
-        KERNEL(sumj, dst[idx] = LOAD(src[idx]) + LOAD(src[idx + jstride]))
-        KERNEL(sumk, dst[idx] = LOAD(src[idx]) + LOAD(src[idx + kstride]))
-        KERNEL(lapij,
-            dst[idx] = LOAD(src[idx]) + LOAD(src[idx - istride]) + LOAD(src[idx + istride]) + LOAD(src[idx - jstride]) +
-                       LOAD(src[idx + jstride]))
-
-#define KERNEL_CALL(name)                                     \
-    void name() override {                                    \
-        kernel_##name<<<blocks(), blocksize()>>>(this->dst(), \
-            this->src(),                                      \
-            this->isize(),                                    \
-            this->jsize(),                                    \
-            this->ksize(),                                    \
-            this->istride(),                                  \
-            this->jstride(),                                  \
-            this->kstride());                                 \
-        if (cudaDeviceSynchronize() != cudaSuccess)           \
-            throw ERROR("error in cudaDeviceSynchronize");    \
-    }
+        template <class Stencil, class ValueType>
+        __global__ void kernel_ij_blocked(ValueType *__restrict__ dst,
+            const ValueType *__restrict__ src,
+            int isize,
+            int jsize,
+            int ksize,
+            int istride,
+            int jstride,
+            int kstride) {
+            const int i = blockIdx.x * blockDim.x + threadIdx.x;
+            const int j = blockIdx.y * blockDim.y + threadIdx.y;
+
+            int idx = i * istride + j * jstride;
+            for (int k = 0; k < ksize; ++k) {
+                if (i < isize && j < jsize) {
+                    dst[idx] = Stencil::eval(src + idx, istride, jstride, kstride);
+                    idx += kstride;
+                }
+            }
+        }
 
         template <class Platform, class ValueType>
         class variant_ij_blocked final : public basic_stencil_variant<Platform, ValueType> {
@@ -88,17 +57,24 @@ namespace platform {
                     throw ERROR("error in cudaDeviceSynchronize");
             }
 
-            KERNEL_CALL(copy)
-            KERNEL_CALL(copyi)
-            KERNEL_CALL(copyj)
-            KERNEL_CALL(copyk)
-            KERNEL_CALL(avgi)
-            KERNEL_CALL(avgj)
-            KERNEL_CALL(avgk)
-            KERNEL_CALL(sumi)
-            KERNEL_CALL(sumj)
-            KERNEL_CALL(sumk)
-            KERNEL_CALL(lapij)
+            template <class Stencil>
+            void kernel() {
+                kernel_ij_blocked<Stencil><<<blocks(), blocksize()>>>(this->dst(),
+                    this->src(),
+                    this->isize(),
+                    this->jsize(),
+                    this->ksize(),
+                    this->istride(),
+                    this->jstride(),
+                    this->kstride());
+                if (cudaDeviceSynchronize() != cudaSuccess)
+                    throw ERROR("error in cudaDeviceSynchronize");
+            }
+
+          protected:
+            std::function<void()> stencil_function(const std::string &stencil) override {
+                return basic_stencil::kernel_function(this, stencil);
+            }
 
           private:
             dim3 blocks() const {
@@ -114,6 +90,3 @@ namespace platform {
     } // namespace cuda
 
 } // namespace platform
-
-#undef LOAD
-#undef KERNEL
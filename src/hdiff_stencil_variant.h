@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <iterator>
 #include <random>
 
@@ -15,20 +16,29 @@ namespace platform {
         using value_type = ValueType;
         using allocator = typename platform::template allocator<value_type>;
 
-        hdiff_stencil_variant(const arguments_map &args);
+        // variants that keep lap, flx and fly in local buffers pass allocate_intermediates = false
+        hdiff_stencil_variant(const arguments_map &args, bool allocate_intermediates = true);
         virtual ~hdiff_stencil_variant() {}
 
         std::vector<std::string> stencil_list() const override;
 
         void prerun() override;
 
+        // one application of the stencil from in() to out()
         virtual void hdiff() = 0;
 
+        // applies the stencil timesteps() times, the final result ends up in out(), in() is left unchanged;
+        // the default implementation calls hdiff() once per step, ping-ponging between out() and tmp()
+        virtual void hdiff_timesteps();
+
       protected:
-        value_type *in() { return m_in.data() + zero_offset(); }
+        // during hdiff_timesteps(), in() and out() are the source and destination of the current step
+        value_type *in() { return m_step_in; }
         value_type *coeff() { return m_coeff.data() + zero_offset(); }
 
-        value_type *out() { return m_out.data() + zero_offset(); }
+        value_type *out() { return m_step_out; }
+        // second ping-pong buffer, only allocated if timesteps() > 1
+        value_type *tmp() { return m_tmp.data() + zero_offset(); }
         value_type *lap() { return m_lap.data() + zero_offset(); }
         value_type *flx() { return m_flx.data() + zero_offset(); }
         value_type *fly() { return m_fly.data() + zero_offset(); }
@@ -45,30 +55,48 @@ namespace platform {
         std::size_t touched_elements(const std::string &stencil) const override;
         std::size_t bytes_per_element() const override { return sizeof(value_type); }
 
+        int timesteps() const { return m_timesteps; }
+
         std::vector<value_type, allocator> m_in, m_coeff;
-        std::vector<value_type, allocator> m_lap, m_flx, m_fly, m_out;
+        std::vector<value_type, allocator> m_lap, m_flx, m_fly, m_out, m_tmp;
         std::vector<value_type> m_lap_ref, m_flx_ref, m_fly_ref, m_out_ref;
+
+      private:
+        int m_timesteps;
+        value_type *m_step_in, *m_step_out;
     };
 
     template <class Platform, class ValueType>
-    hdiff_stencil_variant<Platform, ValueType>::hdiff_stencil_variant(const arguments_map &args)
-        : variant_base(args), m_in(storage_size()), m_coeff(storage_size()), m_lap(storage_size()),
-          m_flx(storage_size()), m_fly(storage_size()), m_out(storage_size()), m_lap_ref(storage_size()),
-          m_flx_ref(storage_size()), m_fly_ref(storage_size()), m_out_ref(storage_size()) {
+    hdiff_stencil_variant<Platform, ValueType>::hdiff_stencil_variant(
+        const arguments_map &args, bool allocate_intermediates)
+        : variant_base(args), m_in(storage_size()), m_coeff(storage_size()),
+          m_lap(allocate_intermediates ? storage_size() : 0), m_flx(allocate_intermediates ? storage_size() : 0),
+          m_fly(allocate_intermediates ? storage_size() : 0), m_out(storage_size()), m_lap_ref(storage_size()),
+          m_flx_ref(storage_size()), m_fly_ref(storage_size()), m_out_ref(storage_size()),
+          m_timesteps(args.get<int>("timesteps")) {
+        if (m_timesteps <= 0)
+            throw ERROR("invalid number of time steps");
+        if (m_timesteps > 1)
+            m_tmp.resize(storage_size());
+        m_step_in = m_in.data() + zero_offset();
+        m_step_out = m_out.data() + zero_offset();
 #pragma omp parallel
         {
             std::minstd_rand eng;
             std::uniform_real_distribution<value_type> dist(-1, 1);
 
             int total_size = storage_size();
+            const bool intermediates = !m_lap.empty();
 #pragma omp for
             for (int i = 0; i < total_size; ++i) {
                 m_in.at(i) = dist(eng);
                 m_out.at(i) = dist(eng);
                 m_coeff.at(i) = dist(eng);
-                m_lap.at(i) = dist(eng);
-                m_flx.at(i) = dist(eng);
-                m_fly.at(i) = dist(eng);
+                if (intermediates) {
+                    m_lap.at(i) = dist(eng);
+                    m_flx.at(i) = dist(eng);
+                    m_fly.at(i) = dist(eng);
+                }
                 m_out_ref.at(i) = dist(eng);
                 m_flx_ref.at(i) = dist(eng);
                 m_fly_ref.at(i) = dist(eng);
@@ -87,6 +115,7 @@ namespace platform {
         variant_base::prerun();
         int total_size = storage_size();
         int cnt = 0;
+        const bool intermediates = !m_lap.empty();
         double dx = 1. / (double)(isize());
         double dy = 1. / (double)(jsize());
         double dz = 1. / (double)(ksize());
@@ -107,9 +136,11 @@ namespace platform {
                                        4.;
                     m_out[cnt] = 5.4;
                     m_out_ref[cnt] = 5.4;
-                    m_flx[cnt] = 0.0;
-                    m_fly[cnt] = 0.0;
-                    m_lap[cnt] = 0.0;
+                    if (intermediates) {
+                        m_flx[cnt] = 0.0;
+                        m_fly[cnt] = 0.0;
+                        m_lap[cnt] = 0.0;
+                    }
                     m_flx_ref[cnt] = 0.0;
                     m_fly_ref[cnt] = 0.0;
                     m_lap_ref[cnt] = 0.0;
@@ -117,12 +148,31 @@ namespace platform {
                 }
             }
         }
+        // the halo is not updated by the stencil, in iterated mode all buffers share the halo of in
+        if (m_timesteps > 1) {
+            std::copy(m_in.begin(), m_in.end(), m_out.begin());
+            std::copy(m_in.begin(), m_in.end(), m_tmp.begin());
+        }
+    }
+
+    template <class Platform, class ValueType>
+    void hdiff_stencil_variant<Platform, ValueType>::hdiff_timesteps() {
+        value_type *in = m_in.data() + zero_offset();
+        value_type *out = m_out.data() + zero_offset();
+        for (int t = 0; t < m_timesteps; ++t) {
+            // the destination alternates such that the last step writes to out
+            m_step_out = (m_timesteps - 1 - t) % 2 == 0 ? out : tmp();
+            hdiff();
+            m_step_in = m_step_out;
+        }
+        m_step_in = in;
+        m_step_out = out;
     }
 
     template <class Platform, class ValueType>
     std::function<void()> hdiff_stencil_variant<Platform, ValueType>::stencil_function(const std::string &stencil) {
         if (stencil == "hdiff")
-            return std::bind(&hdiff_stencil_variant::hdiff, this);
+            return std::bind(&hdiff_stencil_variant::hdiff_timesteps, this);
         throw ERROR("unknown stencil '" + stencil + "'");
     }
 
@@ -139,38 +189,54 @@ namespace platform {
         const int jsize = this->jsize();
         const int ksize = this->ksize();
 
-        for (int k = 0; k < ksize; ++k) {
-            for (int j = -1; j < jsize + 1; ++j) {
-                for (int i = -1; i < isize + 1; ++i) {
-                    lap_ref()[index(i, j, k)] =
-                        4 * in()[index(i, j, k)] - (in()[index(i - 1, j, k)] + in()[index(i + 1, j, k)] +
-                                                       in()[index(i, j - 1, k)] + in()[index(i, j + 1, k)]);
+        // successive applications of the reference, the input of later steps is the previous out_ref with the
+        // halo of in
+        std::vector<value_type> src_ref;
+        const value_type *src = in();
+        for (int t = 0; t < m_timesteps; ++t) {
+            for (int k = 0; k < ksize; ++k) {
+                for (int j = -1; j < jsize + 1; ++j) {
+                    for (int i = -1; i < isize + 1; ++i) {
+                        lap_ref()[index(i, j, k)] =
+                            4 * src[index(i, j, k)] - (src[index(i - 1, j, k)] + src[index(i + 1, j, k)] +
+                                                       src[index(i, j - 1, k)] + src[index(i, j + 1, k)]);
+                    }
                 }
-            }
 
-            for (int j = 0; j < jsize; ++j) {
-                for (int i = -1; i < isize; ++i) {
-                    flx_ref()[index(i, j, k)] = lap_ref()[index(i + 1, j, k)] - lap_ref()[index(i, j, k)];
-                    if (flx_ref()[index(i, j, k)] * (in()[index(i + 1, j, k)] - in()[index(i, j, k)]) > 0)
-                        flx_ref()[index(i, j, k)] = 0.;
+                for (int j = 0; j < jsize; ++j) {
+                    for (int i = -1; i < isize; ++i) {
+                        flx_ref()[index(i, j, k)] = lap_ref()[index(i + 1, j, k)] - lap_ref()[index(i, j, k)];
+                        if (flx_ref()[index(i, j, k)] * (src[index(i + 1, j, k)] - src[index(i, j, k)]) > 0)
+                            flx_ref()[index(i, j, k)] = 0.;
+                    }
+                }
+
+                for (int j = -1; j < jsize; ++j) {
+                    for (int i = 0; i < isize; ++i) {
+                        fly_ref()[index(i, j, k)] = lap_ref()[index(i, j + 1, k)] - lap_ref()[index(i, j, k)];
+                        if (fly_ref()[index(i, j, k)] * (src[index(i, j + 1, k)] - src[index(i, j, k)]) > 0)
+                            fly_ref()[index(i, j, k)] = 0.;
+                    }
                 }
-            }
 
-            for (int j = -1; j < jsize; ++j) {
                 for (int i = 0; i < isize; ++i) {
-                    fly_ref()[index(i, j, k)] = lap_ref()[index(i, j + 1, k)] - lap_ref()[index(i, j, k)];
-                    if (fly_ref()[index(i, j, k)] * (in()[index(i, j + 1, k)] - in()[index(i, j, k)]) > 0)
-                        fly_ref()[index(i, j, k)] = 0.;
+                    for (int j = 0; j < jsize; ++j) {
+                        out_ref()[index(i, j, k)] =
+                            src[index(i, j, k)] -
+                            coeff()[index(i, j, k)] * (flx_ref()[index(i, j, k)] - flx_ref()[index(i - 1, j, k)] +
+                                                       fly_ref()[index(i, j, k)] - fly_ref()[index(i, j - 1, k)]);
+                    }
                 }
             }
 
-            for (int i = 0; i < isize; ++i) {
-                for (int j = 0; j < jsize; ++j) {
-                    out_ref()[index(i, j, k)] =
-                        in()[index(i, j, k)] -
-                        coeff()[index(i, j, k)] * (flx_ref()[index(i, j, k)] - flx_ref()[index(i - 1, j, k)] +
-                                                      fly_ref()[index(i, j, k)] - fly_ref()[index(i, j - 1, k)]);
-                }
+            if (t + 1 < m_timesteps) {
+                if (src_ref.empty())
+                    src_ref.assign(m_in.begin(), m_in.end());
+                src = src_ref.data() + zero_offset();
+                for (int k = 0; k < ksize; ++k)
+                    for (int j = 0; j < jsize; ++j)
+                        for (int i = 0; i < isize; ++i)
+                            src_ref[zero_offset() + index(i, j, k)] = out_ref()[index(i, j, k)];
             }
         }
 
@@ -198,7 +264,7 @@ namespace platform {
         std::size_t j = jsize();
         std::size_t k = ksize();
         // TODO: better estimate
-        return i * j * k * 6;
+        return i * j * k * 6 * m_timesteps;
     }
 
 } // namespace platform
@@ -0,0 +1,168 @@
+#include "jit.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <fstream>
+#include <functional>
+#include <sstream>
+
+#include <dlfcn.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "except.h"
+
+#ifndef JIT_SOURCE_DIR
+#define JIT_SOURCE_DIR "src"
+#endif
+
+// USERFLAGS of the build, so JIT-compiled kernels target the same instruction set as the binary
+#ifndef JIT_BUILD_FLAGS
+#define JIT_BUILD_FLAGS ""
+#endif
+
+namespace platform {
+
+    namespace jit {
+
+        namespace {
+
+            std::string default_cache() {
+                const char *xdg_cache = std::getenv("XDG_CACHE_HOME");
+                if (xdg_cache && *xdg_cache)
+                    return std::string(xdg_cache) + "/stencil_bench_jit";
+                const char *home = std::getenv("HOME");
+                if (home && *home)
+                    return std::string(home) + "/.cache/stencil_bench_jit";
+                throw ERROR("could not determine JIT cache directory, please set --jit-cache");
+            }
+
+            // creates the cache directory if needed; as libraries from the cache are loaded without further checks,
+            // it must belong to the current user and must not be writable by others
+            void make_cache_directory(const std::string &path) {
+                for (std::size_t pos = path.find('/', 1);; pos = path.find('/', pos + 1)) {
+                    const std::string dir = path.substr(0, pos);
+                    if (mkdir(dir.c_str(), 0700) != 0 && errno != EEXIST)
+                        throw ERROR("could not create JIT cache directory '" + dir + "'");
+                    if (pos == std::string::npos)
+                        break;
+                }
+                struct stat s;
+                if (stat(path.c_str(), &s) != 0 || !S_ISDIR(s.st_mode))
+                    throw ERROR("JIT cache '" + path + "' is not a directory");
+                if (s.st_uid != geteuid() || (s.st_mode & (S_IWGRP | S_IWOTH)))
+                    throw ERROR("JIT cache directory '" + path +
+                                "' must be owned by the current user and must not be writable by others");
+            }
+
+            // cached libraries are only valid for the executable that created them, as they depend on the
+            // headers and the class layouts it was built with
+            std::string executable_stamp() {
+                struct stat s;
+                if (stat("/proc/self/exe", &s) != 0)
+                    return "";
+                std::stringstream ss;
+                ss << s.st_mtime << "-" << s.st_size;
+                return ss.str();
+            }
+
+            std::string read_file(const std::string &path) {
+                std::ifstream f(path);
+                std::stringstream s;
+                s << f.rdbuf();
+                return s.str();
+            }
+
+        } // namespace
+
+        options::options(const arguments_map &args)
+            : compiler(args.get("jit-compiler")), flags(args.get("jit-flags")), cache(args.get("jit-cache")) {
+            if (cache.empty())
+                cache = default_cache();
+        }
+
+        void *compile(const options &opts,
+            const std::vector<std::string> &includes,
+            const std::string &source,
+            const std::string &symbol) {
+#if defined(PLATFORM_X86) || defined(PLATFORM_KNL)
+#if defined(PLATFORM_X86)
+            const std::string platform_flags = "-DPLATFORM_X86";
+            const std::string platform_header = "x86/x86_platform.h";
+#else
+            const std::string platform_flags = "-DPLATFORM_KNL -ffreestanding";
+            const std::string platform_header = "knl/knl_platform.h";
+#endif
+            std::stringstream full_source;
+            full_source << "#include \"" << platform_header << "\"\n";
+            for (const auto &include : includes)
+                full_source << "#include \"" << include << "\"\n";
+            full_source << "\n" << source;
+
+            // build flags plus fixed flags for OpenMP, position independent code and bitwise reproducible floating
+            // point results
+            const std::string command = opts.compiler + " -std=c++11 -O3 -fopenmp -fPIC -shared " + JIT_BUILD_FLAGS +
+                                        " -ffp-contract=off -DNDEBUG " + platform_flags + " -I" + JIT_SOURCE_DIR +
+                                        " " + opts.flags;
+
+            std::stringstream hash;
+            hash << std::hex
+                 << std::hash<std::string>()(command + "\n" + executable_stamp() + "\n" + full_source.str());
+            make_cache_directory(opts.cache);
+            const std::string base = opts.cache + "/kernel_" + hash.str();
+            const std::string library = base + ".so";
+
+            if (access(library.c_str(), R_OK) != 0) {
+                std::stringstream pid;
+                pid << getpid();
+                const std::string src_file = base + "." + pid.str() + ".cpp";
+                const std::string tmp_library = base + "." + pid.str() + ".so";
+                const std::string log_file = base + "." + pid.str() + ".log";
+                {
+                    std::ofstream f(src_file);
+                    f << full_source.str();
+                    if (!f)
+                        throw ERROR("could not write JIT source '" + src_file + "'");
+                }
+                const std::string full_command = command + " " + src_file + " -o " + tmp_library + " > " + log_file +
+                                                 " 2>&1";
+                if (std::system(full_command.c_str()) != 0) {
+                    const std::string log = read_file(log_file);
+                    std::remove(src_file.c_str());
+                    std::remove(log_file.c_str());
+                    throw ERROR("JIT compilation failed, command:\n" + full_command + "\noutput:\n" + log);
+                }
+                // the rename is atomic, so concurrent runs never load a partially written library
+                if (std::rename(tmp_library.c_str(), library.c_str()) != 0)
+                    throw ERROR("could not move JIT library to '" + library + "'");
+                std::remove(src_file.c_str());
+                std::remove(log_file.c_str());
+            }
+
+            void *handle = dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+            if (!handle)
+                throw ERROR("could not load JIT library: " + std::string(dlerror()));
+            void *address = dlsym(handle, symbol.c_str());
+            if (!address)
+                throw ERROR("symbol '" + symbol + "' not found in JIT library '" + library + "'");
+            return address;
+#else
+            throw ERROR("JIT compilation is not supported on this platform");
+#endif
+        }
+
+        std::string type_name(const std::type_info &type) {
+            int status;
+            char *name = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+            if (status != 0 || !name)
+                throw ERROR("could not demangle type name '" + std::string(type.name()) + "'");
+            const std::string result = name;
+            std::free(name);
+            return result;
+        }
+
+    } // namespace jit
+
+} // namespace platform
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include "arguments.h"
+
+namespace platform {
+
+    // runtime compilation of generated kernels with the system compiler
+    namespace jit {
+
+        struct options {
+            options(const arguments_map &args);
+
+            std::string compiler, flags, cache;
+        };
+
+        // compiles a shared library from the given includes and source and returns the address of symbol; the
+        // library is cached in the cache directory under the hash of source and compile command, so repeated runs
+        // with the same source start without compilation
+        void *compile(const options &opts,
+            const std::vector<std::string> &includes,
+            const std::string &source,
+            const std::string &symbol);
+
+        // readable C++ name of a type, as needed in generated source
+        std::string type_name(const std::type_info &type);
+
+    } // namespace jit
+
+} // namespace platform
@@ -17,6 +17,9 @@ namespace platform {
                   m_jblocksize(args.get<int>("j-blocksize")) {
                 if (m_iblocksize <= 0 || m_jblocksize <= 0)
                     throw ERROR("invalid block size");
+                // in and coeff are copied to the stacked layout in prerun, only for the first time step
+                if (this->timesteps() > 1)
+                    throw ERROR("this variant does not support more than one time step");
                 // get number of blocks in I and J
                 m_nbi = std::ceil((double)this->isize()/(double)m_iblocksize);
                 m_nbj = std::ceil((double)this->jsize()/(double)m_jblocksize);
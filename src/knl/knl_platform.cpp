@@ -78,9 +78,12 @@ namespace platform {
                 pargs.command("hdiff-ij-blocked-stacked-layout")
                     .add("i-blocksize", "block size in i-direction", "32")
                     .add("j-blocksize", "block size in j-direction", "8");
-                pargs.command("multifield-1d-nontemporal").add("fields", "number of fields", "5");
+                pargs.command("multifield-1d-nontemporal")
+                    .add("fields", "number of fields", "5")
+                    .add("fields-per-pass", "maximum number of fields read in a single pass", "8");
                 pargs.command("multifield-ij-blocked")
                     .add("fields", "number of fields", "5")
+                    .add("fields-per-pass", "maximum number of fields read in a single pass", "8")
                     .add("i-blocksize", "block size in i-direction", "32")
                     .add("j-blocksize", "block size in j-direction", "8");
                 pargs.command("vadv-2d");
@@ -2,42 +2,6 @@
 
 #include "knl/knl_basic_stencil_variant.h"
 
-#define KERNEL(name, stmt)                                                                                      \
-    void name() override {                                                                                      \
-        const value_type *__restrict__ src = this->src();                                                       \
-        value_type *__restrict__ dst = this->dst();                                                             \
-        const int isize = this->isize();                                                                        \
-        const int jsize = this->jsize();                                                                        \
-        const int ksize = this->ksize();                                                                        \
-        constexpr int istride = 1;                                                                              \
-        const int jstride = this->jstride();                                                                    \
-        const int kstride = this->kstride();                                                                    \
-        if (this->istride() != 1)                                                                               \
-            throw ERROR("this variant is only compatible with unit i-stride layout");                           \
-                                                                                                                \
-        _Pragma("omp parallel for collapse(3)") for (int kb = 0; kb < ksize; kb += m_kblocksize) {              \
-            for (int jb = 0; jb < jsize; jb += m_jblocksize) {                                                  \
-                for (int ib = 0; ib < isize; ib += m_iblocksize) {                                              \
-                    const int imax = ib + m_iblocksize <= isize ? ib + m_iblocksize : isize;                    \
-                    const int jmax = jb + m_jblocksize <= jsize ? jb + m_jblocksize : jsize;                    \
-                    const int kmax = kb + m_kblocksize <= ksize ? kb + m_kblocksize : ksize;                    \
-                    int index = ib * istride + jb * jstride + kb * kstride;                                     \
-                                                                                                                \
-                    for (int k = kb; k < kmax; ++k) {                                                           \
-                        for (int j = jb; j < jmax; ++j) {                                                       \
-                            _Pragma("omp simd") _Pragma("vector nontemporal") for (int i = ib; i < imax; ++i) { \
-                                stmt;                                                                           \
-                                index += istride;                                                               \
-                            }                                                                                   \
-                            index += jstride - (imax - ib) * istride;                                           \
-                        }                                                                                       \
-                        index += kstride - (jmax - jb) * jstride;                                               \
-                    }                                                                                           \
-                }                                                                                               \
-            }                                                                                                   \
-        }                                                                                                       \
-    }
-
 namespace platform {
 
     namespace knl {
@@ -54,19 +18,49 @@ namespace platform {
                     throw ERROR("invalid block size");
             }
 
-            KERNEL(copy, dst[index] = src[index])
-            KERNEL(copyi, dst[index] = src[index + istride])
-            KERNEL(copyj, dst[index] = src[index + jstride])
-            KERNEL(copyk, dst[index] = src[index + kstride])
-            KERNEL(avgi, dst[index] = src[index - istride] + src[index + istride])
-            KERNEL(avgj, dst[index] = src[index - jstride] + src[index + jstride])
-            KERNEL(avgk, dst[index] = src[index - kstride] + src[index + kstride])
-            KERNEL(sumi, dst[index] = src[index] + src[index + istride])
-            KERNEL(sumj, dst[index] = src[index] + src[index + jstride])
-            KERNEL(sumk, dst[index] = src[index] + src[index + kstride])
-            KERNEL(lapij,
-                dst[index] = src[index] + src[index - istride] + src[index + istride] + src[index - jstride] +
-                             src[index + jstride])
+            template <class Stencil>
+            void kernel() {
+                const value_type *__restrict__ src = this->src();
+                value_type *__restrict__ dst = this->dst();
+                const int isize = this->isize();
+                const int jsize = this->jsize();
+                const int ksize = this->ksize();
+                constexpr int istride = 1;
+                const int jstride = this->jstride();
+                const int kstride = this->kstride();
+                if (this->istride() != 1)
+                    throw ERROR("this variant is only compatible with unit i-stride layout");
+
+#pragma omp parallel for collapse(3)
+                for (int kb = 0; kb < ksize; kb += m_kblocksize) {
+                    for (int jb = 0; jb < jsize; jb += m_jblocksize) {
+                        for (int ib = 0; ib < isize; ib += m_iblocksize) {
+                            const int imax = ib + m_iblocksize <= isize ? ib + m_iblocksize : isize;
+                            const int jmax = jb + m_jblocksize <= jsize ? jb + m_jblocksize : jsize;
+                            const int kmax = kb + m_kblocksize <= ksize ? kb + m_kblocksize : ksize;
+                            int index = ib * istride + jb * jstride + kb * kstride;
+
+                            for (int k = kb; k < kmax; ++k) {
+                                for (int j = jb; j < jmax; ++j) {
+#pragma omp simd
+#pragma vector nontemporal
+                                    for (int i = ib; i < imax; ++i) {
+                                        dst[index] = Stencil::eval(src + index, istride, jstride, kstride);
+                                        index += istride;
+                                    }
+                                    index += jstride - (imax - ib) * istride;
+                                }
+                                index += kstride - (jmax - jb) * jstride;
+                            }
+                        }
+                    }
+                }
+            }
+
+          protected:
+            std::function<void()> stencil_function(const std::string &stencil) override {
+                return this->kernel_function(this, stencil, "knl/knl_variant_ijk_blocked.h");
+            }
 
           private:
             int m_iblocksize, m_jblocksize, m_kblocksize;
@@ -75,5 +69,3 @@ namespace platform {
     } // namespace knl
 
 } // namespace platform
-
-#undef KERNEL
@@ -33,6 +33,8 @@ std::string metric_info(const arguments_map &args) {
         return "# shown is the measured min. time in ms";
     else if (m == "bandwidth")
         return "# shown is the estimated max. bandwidth in GB/s";
+    else if (m == "flops")
+        return "# shown is the estimated max. floating point performance in GFLOP/s";
     else if (m == "papi")
         return "# shown is the measured min. counter value";
     else if (m == "papi-imbalance")
@@ -47,6 +49,8 @@ double get_metric(const arguments_map &args, const result &r) {
         return r.time.min();
     else if (m == "bandwidth")
         return r.bandwidth.max();
+    else if (m == "flops")
+        return r.flops.max();
     else if (m == "papi")
         return r.counter.min();
     else if (m == "papi-imbalance")
@@ -62,9 +66,9 @@ std::vector<result> run_stencils(const arguments_map &args) {
 }
 
 void run_single_size(const arguments_map &args, std::ostream &out) {
-    out << "# times are given in milliseconds, bandwidth in GB/s" << std::endl;
+    out << "# times are given in milliseconds, bandwidth in GB/s, flops in GFLOP/s" << std::endl;
 
-    table t(13);
+    table t(16);
     t << "Stencil"
       << "Time-avg"
       << "Time-min"
@@ -77,12 +81,16 @@ void run_single_size(const arguments_map &args, std::ostream &out) {
       << "CTR-max"
       << "CTR-IMB-avg"
       << "CTR-IMB-min"
-      << "CTR-IMB-max";
+      << "CTR-IMB-max"
+      << "FLOPS-avg"
+      << "FLOPS-min"
+      << "FLOPS-max";
 
     auto print_result = [&t](const result &r) {
         t << r.stencil << (r.time.avg() * 1000) << (r.time.min() * 1000) << (r.time.max() * 1000) << r.bandwidth.avg()
           << r.bandwidth.min() << r.bandwidth.max() << r.counter.avg() << r.counter.min() << r.counter.max()
-          << r.counter_imbalance.avg() << r.counter_imbalance.min() << r.counter_imbalance.max();
+          << r.counter_imbalance.avg() << r.counter_imbalance.min() << r.counter_imbalance.max() << r.flops.avg()
+          << r.flops.min() << r.flops.max();
     };
 
     const auto res = run_stencils(args);
@@ -90,6 +98,9 @@ void run_single_size(const arguments_map &args, std::ostream &out) {
         print_result(r);
 
     out << t;
+    for (auto &r : res)
+        for (auto &note : r.notes)
+            out << "# " << note << std::endl;
 }
 
 void run_ij_scaling(const arguments_map &args, std::ostream &out) {
@@ -155,6 +166,17 @@ void run_blocksize_scan(const arguments_map &args, std::ostream &out) {
     if (min_size <= 0)
         throw ERROR("invalid min-size < 1");
 
+    // names of the scanned block size arguments, e.g. the L1 sub-tile sizes of a two-level blocked variant
+    const std::string scan_args = args.get("scan-args");
+    const auto comma = scan_args.find(',');
+    if (comma == std::string::npos)
+        throw ERROR("invalid scan-args '" + scan_args + "', expected two comma-separated argument names");
+    const std::string iarg = scan_args.substr(0, comma);
+    const std::string jarg = scan_args.substr(comma + 1);
+    // throws if the variant does not have the arguments
+    args.get_raw(iarg);
+    args.get_raw(jarg);
+
     int jsizes = 0;
     for (int jblocksize = min_size; jblocksize < 2 * jsize; jblocksize *= 2)
         ++jsizes;
@@ -171,13 +193,46 @@ void run_blocksize_scan(const arguments_map &args, std::ostream &out) {
         for (int jblocksize = min_size; jblocksize < 2 * jsize; jblocksize *= 2) {
             std::stringstream jbs;
             jbs << jblocksize;
-            auto res = run_stencils(args.with({{"i-blocksize", ibs.str()}, {"j-blocksize", jbs.str()}}));
+            auto res = run_stencils(args.with({{iarg, ibs.str()}, {jarg, jbs.str()}}));
             t << get_metric(args, res.front());
         }
     }
     out << t;
 }
 
+void run_fields_scan(const arguments_map &args, std::ostream &out) {
+    out << metric_info(args) << std::endl;
+
+    const int fields_max = args.get<int>("fields");
+    if (fields_max <= 0)
+        throw ERROR("invalid number of fields");
+
+    std::string stencil = args.get("stencil");
+    std::map<std::string, std::vector<double>> res_map;
+
+    for (int fields = 1; fields <= fields_max; ++fields) {
+        std::stringstream fields_stream;
+        fields_stream << fields;
+
+        auto res = run_stencils(args.with({{"fields", fields_stream.str()}}));
+        for (auto &r : res) {
+            res_map[r.stencil].push_back(get_metric(args, r));
+        }
+    }
+
+    table t(fields_max + 1);
+    t << "Stencil";
+    for (int fields = 1; fields <= fields_max; ++fields)
+        t << fields;
+
+    for (const auto &r : res_map) {
+        t << r.first;
+        for (auto &v : r.second)
+            t << v;
+    }
+    out << t;
+}
+
 int main(int argc, char **argv) {
     arguments args(argv[0], "platform");
 
@@ -192,9 +247,16 @@ int main(int argc, char **argv) {
         .add("alignment", "alignment in elements", "1")
         .add("precision", "single or double precision", "double")
         .add("stencil", "stencil to run", "all")
-        .add("run-mode", "run mode (single-size, ij-scaling, blocksize-scan)", "single-size")
+        .add("timesteps", "number of successive applications of the hdiff stencil", "1")
+        .add("stencil-expr", "additional basic stencil 'expr', e.g. \"dst = src[-1,0,0] + 2*src[0,0,0] + src[1,0,0]\"")
+        .add("jit-compiler", "compiler for JIT-compiled kernels", "c++")
+        .add("jit-flags", "compiler flags for JIT-compiled kernels, added to the flags of the build")
+        .add("jit-cache", "cache directory of JIT-compiled kernels (default: $XDG_CACHE_HOME/stencil_bench_jit)")
+        .add("run-mode", "run mode (single-size, ij-scaling, blocksize-scan, fields-scan)", "single-size")
+        .add("scan-args", "block size arguments varied in blocksize-scan run-mode (i-argument,j-argument)",
+            "i-blocksize,j-blocksize")
         .add("threads", "number of threads to use (0 = use OMP_NUM_THREADS)", "0")
-        .add("metric", "what to measure (time, bandwidth, papi, papi-imbalance)", "bandwidth")
+        .add("metric", "what to measure (time, bandwidth, flops, papi, papi-imbalance)", "bandwidth")
 #ifdef WITH_PAPI
         .add("papi-event", "PAPI event name", "PAPI_L2_TCM")
 #endif
@@ -231,6 +293,8 @@ int main(int argc, char **argv) {
         run_ij_scaling(argsmap, out);
     else if (run_mode == "blocksize-scan")
         run_blocksize_scan(argsmap, out);
+    else if (run_mode == "fields-scan")
+        run_fields_scan(argsmap, out);
     else
         throw ERROR("invalid run-mode");
 
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+// largest field count for which kernels are generated, bounds fields-per-pass
+#ifndef MULTIFIELD_MAX_FIELDS
+#define MULTIFIELD_MAX_FIELDS 10
+#endif
+
+// the kernels only vectorize if the whole field sum is inlined into the loop body
+#define MULTIFIELD_INLINE inline __attribute__((always_inline))
+#define MULTIFIELD_INLINE_LAMBDA __attribute__((always_inline))
+
+namespace platform {
+
+    namespace multifield {
+
+        // field storage layouts, get(field, idx) reads a field at an index relative to the zero offset,
+        // from(field) returns the same layout with field renumbered to 0
+
+        // one array per field
+        template <class ValueType>
+        struct soa {
+            using value_type = ValueType;
+            const ValueType *const *src;
+
+            MULTIFIELD_INLINE ValueType get(int field, int idx) const { return src[field][idx]; }
+            soa from(int field) const { return {src + field}; }
+        };
+
+        // fields interleaved per element, src points to field 0 at the zero offset
+        template <class ValueType>
+        struct aos {
+            using value_type = ValueType;
+            const ValueType *src;
+            int fields;
+
+            MULTIFIELD_INLINE ValueType get(int field, int idx) const {
+                return src[std::ptrdiff_t(idx) * fields + field];
+            }
+            aos from(int field) const { return {src + field, fields}; }
+        };
+
+        // fields interleaved per block of Width elements, src points to field 0 of the first block,
+        // blocks start at the beginning of the storage, not at the zero offset; the storage has one additional
+        // block before the first and after the last block, see aosoa_block_view
+        template <class ValueType, int Width>
+        struct aosoa {
+            using value_type = ValueType;
+            const ValueType *src;
+            int fields, zero_offset;
+
+            MULTIFIELD_INLINE ValueType get(int field, int idx) const {
+                const std::ptrdiff_t p = idx + zero_offset;
+                return src[p / Width * (std::ptrdiff_t(Width) * fields) + field * Width + p % Width];
+            }
+            aosoa from(int field) const { return {src + field * Width, fields, zero_offset}; }
+        };
+
+        // index of the aosoa kernels: lane in [0, Width) of the current block, plus the offset added by the
+        // stencil; keeping both apart lets the view split the offset into whole blocks and a lane shift once
+        // per block instead of once per element
+        struct block_index {
+            int lane, offset;
+        };
+
+        MULTIFIELD_INLINE block_index operator+(block_index i, int offset) { return {i.lane, i.offset + offset}; }
+        MULTIFIELD_INLINE block_index operator-(block_index i, int offset) { return {i.lane, i.offset - offset}; }
+
+        // what the stencils see in the aosoa kernels: src(i) is the sum over Fields fields of the element at
+        // i.lane + i.offset relative to the first lane of block, which lies either in the block at offset / Width or
+        // in the one after it; both candidates are unit-stride loads and are blended per lane, the unused one may
+        // read one block beyond the actual data
+        template <int Fields, class ValueType, int Width>
+        struct aosoa_block_view {
+            const ValueType *block;
+            int fields;
+
+            MULTIFIELD_INLINE ValueType operator()(block_index i) const {
+                const int q = i.offset >= 0 ? i.offset / Width : -((Width - 1 - i.offset) / Width);
+                const int r = i.offset - q * Width;
+                const ValueType *lo = block + std::ptrdiff_t(q) * Width * fields + r;
+                const ValueType *hi = lo + (Width * fields - Width);
+                const bool in_lo = i.lane < Width - r;
+                ValueType sum = 0;
+                for (int field = 0; field < Fields; ++field) {
+                    const ValueType a = lo[field * Width + i.lane], b = hi[field * Width + i.lane];
+                    sum += in_lo ? a : b;
+                }
+                return sum;
+            }
+        };
+
+        // sum over the first Fields fields at a single index, unrolled at compile time in field order
+        template <int Fields>
+        struct field_sum {
+            template <class Layout>
+            static MULTIFIELD_INLINE typename Layout::value_type apply(const Layout &layout, int idx) {
+                return field_sum<Fields - 1>::apply(layout, idx) + layout.get(Fields - 1, idx);
+            }
+        };
+
+        template <>
+        struct field_sum<1> {
+            template <class Layout>
+            static MULTIFIELD_INLINE typename Layout::value_type apply(const Layout &layout, int idx) {
+                return layout.get(0, idx);
+            }
+        };
+
+        // what the stencils see: src(idx) is the sum over all Fields fields
+        template <int Fields, class Layout>
+        struct fields_view {
+            Layout layout;
+
+            MULTIFIELD_INLINE typename Layout::value_type operator()(int idx) const {
+                return field_sum<Fields>::apply(layout, idx);
+            }
+        };
+
+#define STENCIL(name, expr)                                                                    \
+    struct name {                                                                              \
+        int istride, jstride, kstride;                                                         \
+                                                                                               \
+        template <class Src, class Index>                                                      \
+        MULTIFIELD_INLINE auto operator()(const Src &src, Index i) const -> decltype(src(i)) { \
+            return expr;                                                                       \
+        }                                                                                      \
+    };
+
+        STENCIL(copy, src(i))
+        STENCIL(copyi, src(i + istride))
+        STENCIL(copyj, src(i + jstride))
+        STENCIL(copyk, src(i + kstride))
+        STENCIL(avgi, src(i - istride) + src(i + istride))
+        STENCIL(avgj, src(i - jstride) + src(i + jstride))
+        STENCIL(avgk, src(i - kstride) + src(i + kstride))
+        STENCIL(sumi, src(i) + src(i + istride))
+        STENCIL(sumj, src(i) + src(i + jstride))
+        STENCIL(sumk, src(i) + src(i + kstride))
+        STENCIL(lapij, src(i) + src(i - istride) + src(i + istride) + src(i - jstride) + src(i + jstride))
+
+#undef STENCIL
+
+        // dst[i] = stencil(src, i) or dst[i] += stencil(src, i) for i in [begin, end), over Fields fields
+        template <int Fields, class Layout, class Stencil>
+        MULTIFIELD_INLINE void apply(const Layout &src,
+            const Stencil &stencil,
+            typename Layout::value_type *__restrict__ dst,
+            int begin,
+            int end,
+            bool accumulate) {
+            const fields_view<Fields, Layout> s{src};
+            if (accumulate) {
+#pragma omp simd
+                for (int i = begin; i < end; ++i)
+                    dst[i] += stencil(s, i);
+            } else {
+#pragma omp simd
+                for (int i = begin; i < end; ++i)
+                    dst[i] = stencil(s, i);
+            }
+        }
+
+        // the same for aosoa, iterating over the storage blocks covering [begin, end) and over the lanes of each
+        // block, so all loads are unit-stride
+        template <int Fields, class ValueType, int Width, class Stencil>
+        MULTIFIELD_INLINE void apply(const aosoa<ValueType, Width> &src,
+            const Stencil &stencil,
+            ValueType *__restrict__ dst,
+            int begin,
+            int end,
+            bool accumulate) {
+            const int first = begin + src.zero_offset, last = end + src.zero_offset;
+            for (int b = first / Width; b * Width < last; ++b) {
+                const aosoa_block_view<Fields, ValueType, Width> s{src.src + std::ptrdiff_t(b) * Width * src.fields,
+                    src.fields};
+                ValueType *__restrict__ d = dst + b * Width - src.zero_offset;
+                const int lbegin = std::max(first - b * Width, 0), lend = std::min(last - b * Width, Width);
+                if (accumulate) {
+#pragma omp simd
+                    for (int l = lbegin; l < lend; ++l)
+                        d[l] += stencil(s, block_index{l, 0});
+                } else {
+#pragma omp simd
+                    for (int l = lbegin; l < lend; ++l)
+                        d[l] = stencil(s, block_index{l, 0});
+                }
+            }
+        }
+
+        // calls kernel.template run<N>(args...) with N == fields, valid for 1 <= fields <= Max
+        template <int N, int Max>
+        struct dispatch_fields {
+            template <class Kernel, class... Args>
+            static void apply(int fields, const Kernel &kernel, Args... args) {
+                if (fields == N)
+                    kernel.template run<N>(args...);
+                else
+                    dispatch_fields<N + 1, Max>::apply(fields, kernel, args...);
+            }
+        };
+
+        template <int Max>
+        struct dispatch_fields<Max, Max> {
+            template <class Kernel, class... Args>
+            static void apply(int, const Kernel &kernel, Args... args) {
+                kernel.template run<Max>(args...);
+            }
+        };
+
+        // runs kernel.template run<N>(layout, accumulate, last) over all fields; more than per_pass fields are
+        // processed in passes of at most per_pass fields, accumulating into dst, this bounds the number of
+        // concurrent memory streams and makes any field count possible
+        template <class Kernel, class Layout>
+        void run_passes(const Kernel &kernel, const Layout &layout, int fields, int per_pass) {
+            for (int first = 0; first < fields; first += per_pass) {
+                const int n = std::min(per_pass, fields - first);
+                dispatch_fields<1, MULTIFIELD_MAX_FIELDS>::apply(
+                    n, kernel, layout.from(first), first > 0, first + n == fields);
+            }
+        }
+
+    } // namespace multifield
+
+} // namespace platform
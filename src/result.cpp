@@ -20,9 +20,10 @@ double result_array::avg() const { return std::accumulate(m_data.begin(), m_data
 
 result::result(const std::string &stencil) : stencil(stencil) {}
 
-void result::push_back(double t, double gb, double ctr, double ctr_imb) {
+void result::push_back(double t, double gb, double gflop, double ctr, double ctr_imb) {
     time.m_data.push_back(t);
     bandwidth.m_data.push_back(gb / t);
+    flops.m_data.push_back(gflop / t);
     counter.m_data.push_back(ctr);
     counter_imbalance.m_data.push_back(ctr_imb);
 }
@@ -41,6 +42,7 @@ std::ostream &operator<<(std::ostream &out, const result &r) {
       << "Maximum";
     tdata("Time", "ms", r.time, 1000);
     tdata("Bandwidth", "GB/s", r.bandwidth);
+    tdata("Flops", "GFLOP/s", r.flops);
     tdata("Counter", "", r.counter);
     tdata("Ctr. Imbalance", "", r.counter_imbalance);
 
@@ -22,10 +22,12 @@ struct result {
     result() = default;
     explicit result(const std::string &stencil);
 
-    void push_back(double t, double gb, double ctr, double ctr_imb);
+    void push_back(double t, double gb, double gflop, double ctr, double ctr_imb);
 
     std::string stencil;
-    result_array time, bandwidth, counter, counter_imbalance;
+    result_array time, bandwidth, flops, counter, counter_imbalance;
+    // additional information of the variant, printed as comment lines below the results
+    std::vector<std::string> notes;
 };
 
 std::ostream &operator<<(std::ostream &out, const result &r);
@@ -0,0 +1,446 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <type_traits>
+#include <vector>
+
+namespace platform {
+
+    // compile-time description of a stencil as a graph of stages and an executor that runs it for a given placement
+    // of the intermediate fields and ij-tiling:
+    // - a stage is a struct with a type list 'reads' of read<Field, imin, imax, jmin, jmax> elements, the offsets at
+    //   which it accesses its inputs, and a static function apply(const Env &e, int i, int j) returning its value at
+    //   (i, j) of the current k-level; inputs are accessed with e.template get<Field>(i, j)
+    // - a graph has a type list of input fields 'sources' and one of 'stages' in topological order, the last stage
+    //   is the output
+    // - an intermediate stage is placed in a full field, computed by its own sweep over the domain (full), in
+    //   per-thread tiles, computed per block by the sweep consuming it (block), or is recomputed wherever it is
+    //   read, so its values only live in registers (on_the_fly)
+    namespace stage_graph {
+
+        template <class... Ts>
+        struct list {};
+
+        template <class Field, int IMin, int IMax, int JMin, int JMax>
+        struct read {};
+
+        struct full {};
+        struct block {};
+        struct on_the_fly {};
+
+        template <class Stage, class Placement>
+        struct place {};
+
+        // rectangular set of ij-offsets
+        struct extent {
+            int imin, imax, jmin, jmax;
+            bool empty;
+        };
+
+        constexpr int cmin(int a, int b) { return a < b ? a : b; }
+        constexpr int cmax(int a, int b) { return a > b ? a : b; }
+
+        constexpr extent empty_extent() { return extent{0, 0, 0, 0, true}; }
+        constexpr extent zero_extent() { return extent{0, 0, 0, 0, false}; }
+
+        constexpr extent unite(extent a, extent b) {
+            return a.empty ? b
+                           : b.empty ? a
+                                     : extent{cmin(a.imin, b.imin),
+                                           cmax(a.imax, b.imax),
+                                           cmin(a.jmin, b.jmin),
+                                           cmax(a.jmax, b.jmax),
+                                           false};
+        }
+
+        constexpr extent add(extent a, extent b) {
+            return a.empty || b.empty
+                       ? empty_extent()
+                       : extent{a.imin + b.imin, a.imax + b.imax, a.jmin + b.jmin, a.jmax + b.jmax, false};
+        }
+
+        template <class L1, class L2>
+        struct concat;
+        template <class... T1s, class... T2s>
+        struct concat<list<T1s...>, list<T2s...>> {
+            using type = list<T1s..., T2s...>;
+        };
+
+        template <class F, class L>
+        struct index_of;
+        template <class F, class... Ts>
+        struct index_of<F, list<F, Ts...>> : std::integral_constant<int, 0> {};
+        template <class F, class T, class... Ts>
+        struct index_of<F, list<T, Ts...>> : std::integral_constant<int, 1 + index_of<F, list<Ts...>>::value> {};
+
+        template <class L>
+        struct size;
+        template <class... Ts>
+        struct size<list<Ts...>> : std::integral_constant<int, sizeof...(Ts)> {};
+
+        template <class L>
+        struct last;
+        template <class T>
+        struct last<list<T>> {
+            using type = T;
+        };
+        template <class T, class... Ts>
+        struct last<list<T, Ts...>> : last<list<Ts...>> {};
+
+        template <class F, class L>
+        struct contains;
+        template <class F>
+        struct contains<F, list<>> : std::false_type {};
+        template <class F, class T, class... Ts>
+        struct contains<F, list<T, Ts...>>
+            : std::integral_constant<bool, std::is_same<F, T>::value || contains<F, list<Ts...>>::value> {};
+
+        // placement of a field, sources and the output have their own placements, stages missing in the
+        // configuration are full
+        struct source {};
+        struct output {};
+
+        template <class F, class Config>
+        struct placement_in_config;
+        template <class F>
+        struct placement_in_config<F, list<>> {
+            using type = full;
+        };
+        template <class F, class P, class... Ps>
+        struct placement_in_config<F, list<place<F, P>, Ps...>> {
+            using type = P;
+        };
+        template <class F, class G, class P, class... Ps>
+        struct placement_in_config<F, list<place<G, P>, Ps...>> : placement_in_config<F, list<Ps...>> {};
+
+        template <class Graph, class Config, class F>
+        struct placement_of {
+            using type = typename std::conditional<std::is_same<F, typename last<typename Graph::stages>::type>::value,
+                output,
+                typename std::conditional<contains<F, typename Graph::sources>::value,
+                    source,
+                    typename placement_in_config<F, Config>::type>::type>::type;
+        };
+
+        // offsets at which a stage reads field F, empty if it does not
+        template <class F, class Reads>
+        struct reads_extent;
+        template <class F>
+        struct reads_extent<F, list<>> {
+            static constexpr extent get() { return empty_extent(); }
+        };
+        template <class F, class G, int IMin, int IMax, int JMin, int JMax, class... Rs>
+        struct reads_extent<F, list<read<G, IMin, IMax, JMin, JMax>, Rs...>> {
+            static constexpr extent get() {
+                return unite(std::is_same<F, G>::value ? extent{IMin, IMax, JMin, JMax, false} : empty_extent(),
+                    reads_extent<F, list<Rs...>>::get());
+            }
+        };
+
+        template <class Reader, class F>
+        struct reads : std::integral_constant<bool, !reads_extent<F, typename Reader::reads>::get().empty> {};
+
+        // offsets relative to the domain at which the values of S are needed to compute the output
+        template <class Graph, class S>
+        struct global_extent;
+
+        template <class Graph, class S, class C, bool Reads = reads<C, S>::value>
+        struct global_term {
+            static constexpr extent get() {
+                return add(global_extent<Graph, C>::get(), reads_extent<S, typename C::reads>::get());
+            }
+        };
+        template <class Graph, class S, class C>
+        struct global_term<Graph, S, C, false> {
+            static constexpr extent get() { return empty_extent(); }
+        };
+
+        template <class Graph, class S, class Cs>
+        struct global_union;
+        template <class Graph, class S>
+        struct global_union<Graph, S, list<>> {
+            static constexpr extent get() { return empty_extent(); }
+        };
+        template <class Graph, class S, class C, class... Cs>
+        struct global_union<Graph, S, list<C, Cs...>> {
+            static constexpr extent get() {
+                return unite(global_term<Graph, S, C>::get(), global_union<Graph, S, list<Cs...>>::get());
+            }
+        };
+
+        template <class Graph, class S>
+        struct global_extent {
+            static constexpr extent get() {
+                return std::is_same<S, typename last<typename Graph::stages>::type>::value
+                           ? zero_extent()
+                           : global_union<Graph, S, typename Graph::stages>::get();
+            }
+        };
+
+        // true if stage C is computed by the sweep of stage T: T itself and all block and on-the-fly stages T
+        // depends on without a full stage in between
+        template <class Graph, class Config, class T, class C>
+        struct in_sweep;
+
+        // true if D reads C and is computed by the sweep of T, in_sweep is only instantiated for readers of C
+        template <class Graph, class Config, class T, class C, class D, bool Reads = reads<D, C>::value>
+        struct read_in_sweep_term : in_sweep<Graph, Config, T, D> {};
+        template <class Graph, class Config, class T, class C, class D>
+        struct read_in_sweep_term<Graph, Config, T, C, D, false> : std::false_type {};
+
+        template <class Graph, class Config, class T, class C, class Ds>
+        struct read_in_sweep;
+        template <class Graph, class Config, class T, class C>
+        struct read_in_sweep<Graph, Config, T, C, list<>> : std::false_type {};
+        template <class Graph, class Config, class T, class C, class D, class... Ds>
+        struct read_in_sweep<Graph, Config, T, C, list<D, Ds...>>
+            : std::integral_constant<bool,
+                  read_in_sweep_term<Graph, Config, T, C, D>::value ||
+                      read_in_sweep<Graph, Config, T, C, list<Ds...>>::value> {};
+
+        template <class Graph, class Config, class T, class C>
+        struct in_sweep
+            : std::integral_constant<bool,
+                  std::is_same<T, C>::value ||
+                      ((std::is_same<typename placement_of<Graph, Config, C>::type, block>::value ||
+                           std::is_same<typename placement_of<Graph, Config, C>::type, on_the_fly>::value) &&
+                          read_in_sweep<Graph, Config, T, C, typename Graph::stages>::value)> {};
+
+        // offsets relative to a block at which the values of S are needed by the sweep of T
+        template <class Graph, class Config, class T, class S>
+        struct sweep_extent;
+
+        template <class Graph, class Config, class T, class S, class C,
+            bool Needed = (reads<C, S>::value && in_sweep<Graph, Config, T, C>::value)>
+        struct sweep_term {
+            static constexpr extent get() {
+                return add(sweep_extent<Graph, Config, T, C>::get(), reads_extent<S, typename C::reads>::get());
+            }
+        };
+        template <class Graph, class Config, class T, class S, class C>
+        struct sweep_term<Graph, Config, T, S, C, false> {
+            static constexpr extent get() { return empty_extent(); }
+        };
+
+        template <class Graph, class Config, class T, class S, class Cs>
+        struct sweep_union;
+        template <class Graph, class Config, class T, class S>
+        struct sweep_union<Graph, Config, T, S, list<>> {
+            static constexpr extent get() { return empty_extent(); }
+        };
+        template <class Graph, class Config, class T, class S, class C, class... Cs>
+        struct sweep_union<Graph, Config, T, S, list<C, Cs...>> {
+            static constexpr extent get() {
+                return unite(sweep_term<Graph, Config, T, S, C>::get(),
+                    sweep_union<Graph, Config, T, S, list<Cs...>>::get());
+            }
+        };
+
+        template <class Graph, class Config, class T, class S>
+        struct sweep_extent {
+            static constexpr extent get() {
+                return std::is_same<T, S>::value ? zero_extent()
+                                                 : sweep_union<Graph, Config, T, S, typename Graph::stages>::get();
+            }
+        };
+
+        // per-k-level view of all fields; a field is stored in a slot, element (i, j) is at
+        // ptr[offset + i + j * jstride], on-the-fly stages are evaluated on access
+        template <class Graph, class Config, class ValueType>
+        class env {
+          public:
+            using value_type = ValueType;
+            using fields = typename concat<typename Graph::sources, typename Graph::stages>::type;
+
+            struct slot {
+                value_type *ptr;
+                int offset, jstride;
+            };
+
+            template <class F>
+            value_type get(const int i, const int j) const {
+                return get_impl<F>(i, j, typename placement_of<Graph, Config, F>::type());
+            }
+
+            template <class F>
+            slot &at() {
+                return m_slots[index_of<F, fields>::value];
+            }
+
+            slot &at_index(const int f) { return m_slots[f]; }
+
+          private:
+            template <class F>
+            value_type get_impl(const int i, const int j, on_the_fly) const {
+                return F::apply(*this, i, j);
+            }
+
+            template <class F, class P>
+            value_type get_impl(const int i, const int j, P) const {
+                const slot &s = m_slots[index_of<F, fields>::value];
+                return s.ptr[s.offset + i + j * s.jstride];
+            }
+
+            std::array<slot, size<fields>::value> m_slots;
+        };
+
+        // ij-domain, strides and tiling
+        struct domain {
+            int isize, jsize, ksize;
+            int jstride, kstride;
+            int iblocksize, jblocksize;
+        };
+
+        // runs all sweeps of the graph: one for every full stage and one for the output, in topological order and
+        // separated by barriers; fields holds the pointer to element (0, 0, 0) of every source, full stage and of
+        // the output in the order of sources and stages, entries of the other stages are ignored; unit i-stride
+        template <class Graph, class Config, class ValueType>
+        class executor {
+          public:
+            using value_type = ValueType;
+            using env_type = env<Graph, Config, ValueType>;
+            using fields = typename env_type::fields;
+            using field_pointers = std::array<value_type *, size<fields>::value>;
+
+            static void run(const domain &d, const field_pointers &ptrs) {
+#pragma omp parallel
+                sweeps<typename Graph::stages>::run(d, ptrs);
+            }
+
+          private:
+            template <class S>
+            using placement = typename placement_of<Graph, Config, S>::type;
+
+            template <class Ss>
+            struct sweeps;
+            template <class S, class... Ss>
+            struct sweeps<list<S, Ss...>> {
+                static void run(const domain &d, const field_pointers &ptrs) {
+                    sweep_if<S>(d, ptrs, placement<S>());
+                    sweeps<list<Ss...>>::run(d, ptrs);
+                }
+            };
+            template <class... Ss>
+            struct sweeps<list<Ss...>> {
+                static void run(const domain &, const field_pointers &) {}
+            };
+
+            template <class T>
+            static void sweep_if(const domain &d, const field_pointers &ptrs, full) {
+                sweep<T>(d, ptrs);
+            }
+            template <class T>
+            static void sweep_if(const domain &d, const field_pointers &ptrs, output) {
+                sweep<T>(d, ptrs);
+            }
+            template <class T, class P>
+            static void sweep_if(const domain &, const field_pointers &, P) {}
+
+            using tiles = std::array<std::vector<value_type>, size<fields>::value>;
+
+            // applies F to every stage with its placement
+            template <class Ss>
+            struct for_stages;
+            template <class S, class... Ss>
+            struct for_stages<list<S, Ss...>> {
+                template <class F>
+                static void apply(F &f) {
+                    f.template operator()<S>(placement<S>());
+                    for_stages<list<Ss...>>::apply(f);
+                }
+            };
+            template <class... Ss>
+            struct for_stages<list<Ss...>> {
+                template <class F>
+                static void apply(F &) {}
+            };
+
+            // allocates the tiles of the block stages of the sweep of T
+            template <class T>
+            struct allocate_tiles {
+                const domain &d;
+                tiles &t;
+
+                template <class S>
+                void operator()(block) {
+                    if (in_sweep<Graph, Config, T, S>::value) {
+                        constexpr extent e = sweep_extent<Graph, Config, T, S>::get();
+                        t[index_of<S, fields>::value].resize(
+                            (d.iblocksize + e.imax - e.imin) * (d.jblocksize + e.jmax - e.jmin));
+                    }
+                }
+                template <class S, class P>
+                void operator()(P) {}
+            };
+
+            // computes the block stages of the sweep of T on the block [ib, imax) x [jb, jmax)
+            template <class T>
+            struct compute_tiles {
+                env_type &e;
+                tiles &t;
+                int ib, imax, jb, jmax, iblocksize;
+
+                template <class S>
+                void operator()(block) {
+                    if (in_sweep<Graph, Config, T, S>::value && !std::is_same<S, T>::value) {
+                        constexpr extent x = sweep_extent<Graph, Config, T, S>::get();
+                        auto &s = e.template at<S>();
+                        s.ptr = t[index_of<S, fields>::value].data();
+                        s.jstride = iblocksize + x.imax - x.imin;
+                        s.offset = -(ib + x.imin) - (jb + x.jmin) * s.jstride;
+                        compute<S>(e, ib + x.imin, imax + x.imax, jb + x.jmin, jmax + x.jmax);
+                    }
+                }
+                template <class S, class P>
+                void operator()(P) {}
+            };
+
+            template <class S>
+            static void compute(env_type &e, const int ilo, const int ihi, const int jlo, const int jhi) {
+                const auto s = e.template at<S>();
+                for (int j = jlo; j < jhi; ++j) {
+                    value_type *__restrict__ row = s.ptr + s.offset + j * s.jstride;
+#pragma omp simd
+                    for (int i = ilo; i < ihi; ++i)
+                        row[i] = S::apply(e, i, j);
+                }
+            }
+
+            template <class T>
+            static void sweep(const domain &d, const field_pointers &ptrs) {
+                // region of T, tiled by the blocks
+                constexpr extent r = global_extent<Graph, T>::get();
+                const int ilo = r.imin, ihi = d.isize + r.imax;
+                const int jlo = r.jmin, jhi = d.jsize + r.jmax;
+
+                tiles t;
+                allocate_tiles<T> allocate{d, t};
+                for_stages<typename Graph::stages>::apply(allocate);
+                env_type e;
+
+#pragma omp for collapse(3)
+                for (int k = 0; k < d.ksize; ++k) {
+                    for (int jb = jlo; jb < jhi; jb += d.jblocksize) {
+                        for (int ib = ilo; ib < ihi; ib += d.iblocksize) {
+                            const int imax = std::min(ib + d.iblocksize, ihi);
+                            const int jmax = std::min(jb + d.jblocksize, jhi);
+                            // fields in memory at level k, the block stages are set up by compute_tiles
+                            for (int f = 0; f < size<fields>::value; ++f) {
+                                auto &s = e.at_index(f);
+                                s.ptr = ptrs[f];
+                                s.offset = k * d.kstride;
+                                s.jstride = d.jstride;
+                            }
+                            compute_tiles<T> tiles_of_block{e, t, ib, imax, jb, jmax, d.iblocksize};
+                            for_stages<typename Graph::stages>::apply(tiles_of_block);
+                            compute<T>(e, ib, imax, jb, jmax);
+                        }
+                    }
+                }
+            }
+        };
+
+    } // namespace stage_graph
+
+} // namespace platform
@@ -0,0 +1,210 @@
+#include "stencil_expr.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+#include "except.h"
+
+namespace platform {
+
+    namespace {
+
+        // recursive descent parser for
+        //   expr    := ["dst" "="] ["+" | "-"] product {("+" | "-") product}
+        //   product := [number "*"] "src" "[" int "," int "," int "]" ["*" number]
+        class parser {
+          public:
+            parser(const std::string &s) : m_s(s), m_pos(0) {}
+
+            std::vector<stencil_expr::term> parse() {
+                std::vector<stencil_expr::term> terms;
+                skip();
+                if (m_s.compare(m_pos, 3, "dst") == 0) {
+                    m_pos += 3;
+                    expect('=');
+                }
+                double sign = 1;
+                if (accept('-'))
+                    sign = -1;
+                else
+                    accept('+');
+                terms.push_back(product(sign));
+                while (m_pos < m_s.size()) {
+                    if (accept('+'))
+                        terms.push_back(product(1));
+                    else if (accept('-'))
+                        terms.push_back(product(-1));
+                    else
+                        fail("'+' or '-'");
+                }
+                return terms;
+            }
+
+          private:
+            stencil_expr::term product(const double sign) {
+                stencil_expr::term t;
+                t.coeff = sign;
+                if (peek() != 's') {
+                    t.coeff *= number();
+                    expect('*');
+                }
+                skip();
+                if (m_s.compare(m_pos, 3, "src") != 0)
+                    fail("'src'");
+                m_pos += 3;
+                expect('[');
+                t.di = integer();
+                expect(',');
+                t.dj = integer();
+                expect(',');
+                t.dk = integer();
+                expect(']');
+                if (accept('*'))
+                    t.coeff *= number();
+                return t;
+            }
+
+            double number() {
+                skip();
+                const char *begin = m_s.c_str() + m_pos;
+                char *end;
+                const double value = std::strtod(begin, &end);
+                if (end == begin || !std::isfinite(value))
+                    fail("number");
+                m_pos += end - begin;
+                return value;
+            }
+
+            int integer() {
+                skip();
+                const char *begin = m_s.c_str() + m_pos;
+                char *end;
+                const long value = std::strtol(begin, &end, 10);
+                if (end == begin)
+                    fail("integer offset");
+                m_pos += end - begin;
+                return int(value);
+            }
+
+            char peek() {
+                skip();
+                return m_pos < m_s.size() ? m_s[m_pos] : '\0';
+            }
+
+            bool accept(const char c) {
+                if (peek() != c)
+                    return false;
+                ++m_pos;
+                return true;
+            }
+
+            void expect(const char c) {
+                if (!accept(c))
+                    fail(std::string("'") + c + "'");
+            }
+
+            void skip() {
+                while (m_pos < m_s.size() && std::isspace(static_cast<unsigned char>(m_s[m_pos])))
+                    ++m_pos;
+            }
+
+            void fail(const std::string &expected) const {
+                std::stringstream s;
+                s << "invalid stencil expression '" << m_s << "': expected " << expected << " at position " << m_pos;
+                throw ERROR(s.str());
+            }
+
+            const std::string &m_s;
+            std::size_t m_pos;
+        };
+
+        // C++ literal representing the given value exactly, 17 significant digits are enough for any double
+        std::string literal(const double value) {
+            char buffer[64];
+            std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+            return buffer;
+        }
+
+    } // namespace
+
+    stencil_expr::stencil_expr(const std::string &expr) : m_str(expr), m_terms(parser(expr).parse()) {}
+
+    int stencil_expr::imin() const {
+        return std::min_element(m_terms.begin(), m_terms.end(), [](const term &a, const term &b) {
+            return a.di < b.di;
+        })->di;
+    }
+
+    int stencil_expr::imax() const {
+        return std::max_element(m_terms.begin(), m_terms.end(), [](const term &a, const term &b) {
+            return a.di < b.di;
+        })->di;
+    }
+
+    int stencil_expr::jmin() const {
+        return std::min_element(m_terms.begin(), m_terms.end(), [](const term &a, const term &b) {
+            return a.dj < b.dj;
+        })->dj;
+    }
+
+    int stencil_expr::jmax() const {
+        return std::max_element(m_terms.begin(), m_terms.end(), [](const term &a, const term &b) {
+            return a.dj < b.dj;
+        })->dj;
+    }
+
+    int stencil_expr::kmin() const {
+        return std::min_element(m_terms.begin(), m_terms.end(), [](const term &a, const term &b) {
+            return a.dk < b.dk;
+        })->dk;
+    }
+
+    int stencil_expr::kmax() const {
+        return std::max_element(m_terms.begin(), m_terms.end(), [](const term &a, const term &b) {
+            return a.dk < b.dk;
+        })->dk;
+    }
+
+    std::size_t stencil_expr::flops() const {
+        std::size_t flops = m_terms.size() - 1;
+        for (const term &t : m_terms)
+            if (t.coeff != 1 && t.coeff != -1)
+                ++flops;
+        return flops;
+    }
+
+    std::string stencil_expr::source(const std::string &name) const {
+        // the expression may span several lines, but the comment must not
+        std::string comment = m_str;
+        std::replace_if(comment.begin(),
+            comment.end(),
+            [](char c) { return std::isspace(static_cast<unsigned char>(c)); },
+            ' ');
+        std::stringstream s;
+        s << "// " << comment << "\n"
+          << "struct " << name << " {\n"
+          << "    template <class T>\n"
+          << "    static inline T eval(const T *__restrict__ src, const int istride, const int jstride, "
+             "const int kstride) {\n"
+          << "        return ";
+        for (std::size_t n = 0; n < m_terms.size(); ++n) {
+            const term &t = m_terms[n];
+            if (n > 0)
+                s << (t.coeff < 0 ? " - " : " + ");
+            else if (t.coeff < 0)
+                s << "-";
+            if (t.coeff != 1 && t.coeff != -1)
+                s << "T(" << literal(t.coeff < 0 ? -t.coeff : t.coeff) << ") * ";
+            s << "src[" << t.di << " * istride + " << t.dj << " * jstride + " << t.dk << " * kstride]";
+        }
+        s << ";\n"
+          << "    }\n"
+          << "};\n";
+        return s.str();
+    }
+
+} // namespace platform
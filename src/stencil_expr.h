@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace platform {
+
+    // basic stencil given at runtime as a weighted sum of src values, for example
+    // "dst = src[-1,0,0] + 2*src[0,0,0] + src[1,0,0]"; it is run as stencil "expr" by JIT-compiling the kernel of
+    // the chosen variant, see basic_stencil_variant::kernel_function
+    class stencil_expr {
+      public:
+        struct term {
+            int di, dj, dk;
+            double coeff;
+        };
+
+        explicit stencil_expr(const std::string &expr);
+
+        const std::string &str() const { return m_str; }
+        const std::vector<term> &terms() const { return m_terms; }
+
+        // bounding box of the offsets
+        int imin() const;
+        int imax() const;
+        int jmin() const;
+        int jmax() const;
+        int kmin() const;
+        int kmax() const;
+
+        // additions and multiplications per point
+        std::size_t flops() const;
+
+        // C++ definition of a stencil struct with the given name, usable as Stencil in the kernel<Stencil>()
+        // templates of the basic variants
+        std::string source(const std::string &name) const;
+
+        // reference value at src, evaluated in the same order and with the same operations as the generated
+        // source, so both give bitwise identical results
+        template <class T>
+        T eval(const T *src, const int istride, const int jstride, const int kstride) const {
+            T sum = 0;
+            for (std::size_t n = 0; n < m_terms.size(); ++n) {
+                const term &t = m_terms[n];
+                T v = src[t.di * istride + t.dj * jstride + t.dk * kstride];
+                if (t.coeff != 1 && t.coeff != -1)
+                    v = T(t.coeff < 0 ? -t.coeff : t.coeff) * v;
+                if (n == 0)
+                    sum = t.coeff < 0 ? -v : v;
+                else
+                    sum = t.coeff < 0 ? sum - v : sum + v;
+            }
+            return sum;
+        }
+
+      private:
+        std::string m_str;
+        std::vector<term> m_terms;
+    };
+
+} // namespace platform
@@ -15,7 +15,8 @@ namespace platform {
         using value_type = ValueType;
         using allocator = typename platform::template allocator<value_type>;
 
-        vadv_stencil_variant(const arguments_map &args);
+        // variants that keep ccol, dcol and datacol in local scratch pass allocate_intermediates = false
+        vadv_stencil_variant(const arguments_map &args, bool allocate_intermediates = true);
         virtual ~vadv_stencil_variant() {}
 
         std::vector<std::string> stencil_list() const override;
@@ -61,19 +62,22 @@ namespace platform {
     };
 
     template <class Platform, class ValueType>
-    vadv_stencil_variant<Platform, ValueType>::vadv_stencil_variant(const arguments_map &args)
+    vadv_stencil_variant<Platform, ValueType>::vadv_stencil_variant(
+        const arguments_map &args, bool allocate_intermediates)
         : variant_base(args), m_ustage(storage_size()), m_upos(storage_size()), m_utens(storage_size()),
           m_utensstage(storage_size()), m_vstage(storage_size()), m_vpos(storage_size()), m_vtens(storage_size()),
           m_vtensstage(storage_size()), m_wstage(storage_size()), m_wpos(storage_size()), m_wtens(storage_size()),
-          m_wtensstage(storage_size()), m_ccol(storage_size()), m_dcol(storage_size()), m_wcon(storage_size()),
-          m_datacol(storage_size()), m_utensstage_ref(storage_size()), m_vtensstage_ref(storage_size()),
-          m_wtensstage_ref(storage_size()) {
+          m_wtensstage(storage_size()), m_ccol(allocate_intermediates ? storage_size() : 0),
+          m_dcol(allocate_intermediates ? storage_size() : 0), m_wcon(storage_size()),
+          m_datacol(allocate_intermediates ? storage_size() : 0), m_utensstage_ref(storage_size()),
+          m_vtensstage_ref(storage_size()), m_wtensstage_ref(storage_size()) {
 #pragma omp parallel
         {
             std::minstd_rand eng;
             std::uniform_real_distribution<value_type> dist(-1, 1);
 
             int total_size = storage_size();
+            const bool intermediates = !m_ccol.empty();
 #pragma omp for
             for (int i = 0; i < total_size; ++i) {
                 m_ustage.at(i) = dist(eng);
@@ -88,10 +92,15 @@ namespace platform {
                 m_wpos.at(i) = dist(eng);
                 m_wtens.at(i) = dist(eng);
                 m_wtensstage.at(i) = dist(eng);
-                m_ccol.at(i) = dist(eng);
-                m_dcol.at(i) = dist(eng);
+                // intermediates are drawn in any case, so all variants see the same input fields
+                const value_type ccol = dist(eng), dcol = dist(eng);
                 m_wcon.at(i) = dist(eng);
-                m_datacol.at(i) = dist(eng);
+                const value_type datacol = dist(eng);
+                if (intermediates) {
+                    m_ccol.at(i) = ccol;
+                    m_dcol.at(i) = dcol;
+                    m_datacol.at(i) = datacol;
+                }
             }
         }
     }
@@ -105,14 +114,17 @@ namespace platform {
     void vadv_stencil_variant<Platform, ValueType>::prerun() {
         variant_base::prerun();
         int total_size = storage_size();
+        const bool intermediates = !m_ccol.empty();
 #pragma omp parallel for
         for (int i = 0; i < total_size; ++i) {
             m_utensstage_ref.at(i) = m_utensstage.at(i);
             m_vtensstage_ref.at(i) = m_vtensstage.at(i);
             m_wtensstage_ref.at(i) = m_wtensstage.at(i);
-            m_ccol.at(i) = -1;
-            m_dcol.at(i) = -1;
-            m_datacol.at(i) = -1;
+            if (intermediates) {
+                m_ccol.at(i) = -1;
+                m_dcol.at(i) = -1;
+                m_datacol.at(i) = -1;
+            }
         }
     }
 
@@ -149,17 +161,17 @@ namespace platform {
             {
                 const int k = ksize - 1;
                 const int index = i * istride + j * jstride + k * kstride;
-                datacol[index] = dcol[index];
-                ccol[index] = datacol[index];
-                utensstage[index] = dtr_stage * (datacol[index] - upos[index]);
+                datacol[k] = dcol[k];
+                ccol[k] = datacol[k];
+                utensstage[index] = dtr_stage * (datacol[k] - upos[index]);
             }
 
             // k body
             for (int k = ksize - 2; k >= 0; --k) {
                 const int index = i * istride + j * jstride + k * kstride;
-                datacol[index] = dcol[index] - ccol[index] * datacol[index + kstride];
-                ccol[index] = datacol[index];
-                utensstage[index] = dtr_stage * (datacol[index] - upos[index]);
+                datacol[k] = dcol[k] - ccol[k] * datacol[k + 1];
+                ccol[k] = datacol[k];
+                utensstage[index] = dtr_stage * (datacol[k] - upos[index]);
             }
         };
 
@@ -183,15 +195,15 @@ namespace platform {
 
                 value_type cs = gcv * bet_m;
 
-                ccol[index] = gcv * bet_p;
-                value_type bcol = dtr_stage - ccol[index];
+                ccol[k] = gcv * bet_p;
+                value_type bcol = dtr_stage - ccol[k];
 
                 value_type correction_term = -cs * (ustage[index + kstride] - ustage[index]);
-                dcol[index] = dtr_stage * upos[index] + utens[index] + utensstage[index] + correction_term;
+                dcol[k] = dtr_stage * upos[index] + utens[index] + utensstage[index] + correction_term;
 
                 value_type divided = value_type(1.0) / bcol;
-                ccol[index] = ccol[index] * divided;
-                dcol[index] = dcol[index] * divided;
+                ccol[k] = ccol[k] * divided;
+                dcol[k] = dcol[k] * divided;
             }
 
             // k body
@@ -205,16 +217,16 @@ namespace platform {
                 value_type cs = gcv * bet_m;
 
                 value_type acol = gav * bet_p;
-                ccol[index] = gcv * bet_p;
-                value_type bcol = dtr_stage - acol - ccol[index];
+                ccol[k] = gcv * bet_p;
+                value_type bcol = dtr_stage - acol - ccol[k];
 
                 value_type correction_term =
                     -as * (ustage[index - kstride] - ustage[index]) - cs * (ustage[index + kstride] - ustage[index]);
-                dcol[index] = dtr_stage * upos[index] + utens[index] + utensstage[index] + correction_term;
+                dcol[k] = dtr_stage * upos[index] + utens[index] + utensstage[index] + correction_term;
 
-                value_type divided = value_type(1.0) / (bcol - ccol[index - kstride] * acol);
-                ccol[index] = ccol[index] * divided;
-                dcol[index] = (dcol[index] - dcol[index - kstride] * acol) * divided;
+                value_type divided = value_type(1.0) / (bcol - ccol[k - 1] * acol);
+                ccol[k] = ccol[k] * divided;
+                dcol[k] = (dcol[k] - dcol[k - 1] * acol) * divided;
             }
 
             // k maximum
@@ -229,44 +241,45 @@ namespace platform {
                 value_type bcol = dtr_stage - acol;
 
                 value_type correction_term = -as * (ustage[index - kstride] - ustage[index]);
-                dcol[index] = dtr_stage * upos[index] + utens[index] + utensstage[index] + correction_term;
+                dcol[k] = dtr_stage * upos[index] + utens[index] + utensstage[index] + correction_term;
 
-                value_type divided = value_type(1.0) / (bcol - ccol[index - kstride] * acol);
-                dcol[index] = (dcol[index] - dcol[index - kstride] * acol) * divided;
+                value_type divided = value_type(1.0) / (bcol - ccol[k - 1] * acol);
+                dcol[k] = (dcol[k] - dcol[k - 1] * acol) * divided;
             }
         };
 
-        int total_size = storage_size();
-#pragma omp parallel for
-        for (int i = 0; i < total_size; ++i) {
-            m_ccol.at(i) = -1;
-            m_dcol.at(i) = -1;
-            m_datacol.at(i) = -1;
-        }
+        // the reference keeps ccol, dcol and datacol in column-local scratch, indexed by k only
+#pragma omp parallel
+        {
+            std::vector<value_type> ccol(ksize), dcol(ksize), datacol(ksize);
 
 // generate u
-#pragma omp parallel for collapse(2)
-        for (int j = 0; j < jsize; ++j)
-            for (int i = 0; i < isize; ++i) {
-                forward_sweep(i, j, 1, 0, ccol(), dcol(), wcon(), ustage(), upos(), utens(), utensstage_ref());
-                backward_sweep(i, j, ccol(), dcol(), datacol(), upos(), utensstage_ref());
-            }
+#pragma omp for collapse(2)
+            for (int j = 0; j < jsize; ++j)
+                for (int i = 0; i < isize; ++i) {
+                    forward_sweep(
+                        i, j, 1, 0, ccol.data(), dcol.data(), wcon(), ustage(), upos(), utens(), utensstage_ref());
+                    backward_sweep(i, j, ccol.data(), dcol.data(), datacol.data(), upos(), utensstage_ref());
+                }
 
 // generate v
-#pragma omp parallel for collapse(2)
-        for (int j = 0; j < jsize; ++j)
-            for (int i = 0; i < isize; ++i) {
-                forward_sweep(i, j, 1, 0, ccol(), dcol(), wcon(), vstage(), vpos(), vtens(), vtensstage_ref());
-                backward_sweep(i, j, ccol(), dcol(), datacol(), vpos(), vtensstage_ref());
-            }
+#pragma omp for collapse(2)
+            for (int j = 0; j < jsize; ++j)
+                for (int i = 0; i < isize; ++i) {
+                    forward_sweep(
+                        i, j, 1, 0, ccol.data(), dcol.data(), wcon(), vstage(), vpos(), vtens(), vtensstage_ref());
+                    backward_sweep(i, j, ccol.data(), dcol.data(), datacol.data(), vpos(), vtensstage_ref());
+                }
 
 // generate w
-#pragma omp parallel for collapse(2)
-        for (int j = 0; j < jsize; ++j)
-            for (int i = 0; i < isize; ++i) {
-                forward_sweep(i, j, 1, 0, ccol(), dcol(), wcon(), wstage(), wpos(), wtens(), wtensstage_ref());
-                backward_sweep(i, j, ccol(), dcol(), datacol(), wpos(), wtensstage_ref());
-            }
+#pragma omp for collapse(2)
+            for (int j = 0; j < jsize; ++j)
+                for (int i = 0; i < isize; ++i) {
+                    forward_sweep(
+                        i, j, 1, 0, ccol.data(), dcol.data(), wcon(), wstage(), wpos(), wtens(), wtensstage_ref());
+                    backward_sweep(i, j, ccol.data(), dcol.data(), datacol.data(), wpos(), wtensstage_ref());
+                }
+        }
 
         auto eq = [](value_type a, value_type b) {
             value_type diff = std::abs(a - b);
@@ -295,7 +308,8 @@ namespace platform {
         std::size_t i = isize();
         std::size_t j = jsize();
         std::size_t k = ksize();
-        // TODO: better estimate
+        // compulsory traffic: stage, pos, tens and tensstage of u, v and w and wcon are read, the three tensstage
+        // fields written; ccol, dcol and datacol are intermediates that need not leave the cache
         return i * j * k * 16;
     }
 
@@ -19,7 +19,7 @@ namespace platform {
         : m_halo(args.get<int>("halo")), m_alignment(args.get<int>("alignment")), m_isize(args.get<int>("i-size")),
           m_jsize(args.get<int>("j-size")), m_ksize(args.get<int>("k-size")), m_ilayout(args.get<int>("i-layout")),
           m_jlayout(args.get<int>("j-layout")), m_klayout(args.get<int>("k-layout")),
-          m_data_offset(((m_halo + m_alignment - 1) / m_alignment) * m_alignment - m_halo) {
+          m_data_offset(((m_halo + m_alignment - 1) / m_alignment) * m_alignment - m_halo), m_timed_run(false) {
         if (m_isize <= 0 || m_jsize <= 0 || m_ksize <= 0)
             throw ERROR("invalid domain size");
         if (m_halo <= 0)
@@ -123,9 +123,11 @@ namespace platform {
                         throw ERROR("PAPI error, could not start counters");
                 }
 #endif
+                m_timed_run = i >= dry;
                 auto tstart = clock::now();
                 f();
                 auto tend = clock::now();
+                m_timed_run = false;
 #ifdef WITH_PAPI
                 std::vector<long long> ctrs;
 #pragma omp parallel shared(ctrs)
@@ -148,19 +150,21 @@ namespace platform {
                 } else if (i >= dry) {
                     double t = std::chrono::duration<double>(tend - tstart).count();
                     double gb = touched_bytes(s) / (1024.0 * 1024.0 * 1024.0);
+                    double gflop = flops(s) / 1e9;
 
 #ifdef WITH_PAPI
                     double ctrs_sum = std::accumulate(ctrs.begin(), ctrs.end(), 0ll);
                     double ctr = ctrs_sum / ctrs.size();
                     double ctr_imb = *std::max_element(ctrs.begin(), ctrs.end()) / (ctrs_sum / ctrs.size()) - 1.0;
 
-                    res.push_back(t, gb, ctr, ctr_imb);
+                    res.push_back(t, gb, gflop, ctr, ctr_imb);
 #else
-                    res.push_back(t, gb, 0, 0);
+                    res.push_back(t, gb, gflop, 0, 0);
 #endif
                 }
             }
 
+            res.notes = notes(s);
             results.push_back(res);
         }
         return results;
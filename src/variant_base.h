@@ -37,6 +37,8 @@ namespace platform {
         inline int storage_size() const { return m_storage_size; }
         inline int data_offset() const { return m_data_offset; }
         inline int alignment() const { return m_alignment; }
+        // true while the stencil function runs for a timed measurement, false for dry and verification runs
+        inline bool timed_run() const { return m_timed_run; }
 
         virtual std::function<void()> stencil_function(const std::string &kernel) = 0;
 
@@ -45,7 +47,11 @@ namespace platform {
         virtual bool verify(const std::string &kernel) = 0;
 
         virtual std::size_t touched_elements(const std::string &stencil) const = 0;
+        // floating point operations of one stencil application, 0 if unknown
+        virtual std::size_t flops(const std::string &stencil) const { return 0; }
         virtual std::size_t bytes_per_element() const = 0;
+        // additional information on the runs of a stencil, see result::notes
+        virtual std::vector<std::string> notes(const std::string &stencil) const { return {}; }
 
       private:
         std::size_t touched_bytes(const std::string &stencil) const {
@@ -57,6 +63,7 @@ namespace platform {
         int m_ilayout, m_jlayout, m_klayout;
         int m_istride, m_jstride, m_kstride;
         int m_data_offset, m_storage_size;
+        bool m_timed_run;
 #ifdef WITH_PAPI
         int m_papi_event_code;
 #endif
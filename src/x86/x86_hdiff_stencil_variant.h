@@ -11,7 +11,8 @@ namespace platform {
         template <class Platform, class ValueType>
         class x86_hdiff_stencil_variant : public hdiff_stencil_variant<Platform, ValueType> {
           public:
-            x86_hdiff_stencil_variant(const arguments_map &args) : hdiff_stencil_variant<Platform, ValueType>(args) {
+            x86_hdiff_stencil_variant(const arguments_map &args, bool allocate_intermediates = true)
+                : hdiff_stencil_variant<Platform, ValueType>(args, allocate_intermediates) {
                 Platform::check_cache_conflicts("i-stride offsets", this->istride() * this->bytes_per_element());
                 Platform::check_cache_conflicts("j-stride offsets", this->jstride() * this->bytes_per_element());
                 Platform::check_cache_conflicts("k-stride offsets", this->kstride() * this->bytes_per_element());
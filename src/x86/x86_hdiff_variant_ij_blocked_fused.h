@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "x86/x86_hdiff_stencil_variant.h"
+
+namespace platform {
+
+    namespace x86 {
+
+        // computes lap, flx, fly and out of an ij-block in a single sweep over j: per thread only a rolling window
+        // of three lap rows, two fly rows and one flx row of i-blocksize + 2 elements is kept, which stays in L1;
+        // the full lap, flx and fly fields are not allocated, so in, coeff and out are the only memory traffic
+        template <class Platform, class ValueType>
+        class x86_hdiff_variant_ij_blocked_fused final : public x86_hdiff_stencil_variant<Platform, ValueType> {
+          public:
+            using value_type = ValueType;
+
+            x86_hdiff_variant_ij_blocked_fused(const arguments_map &args)
+                : x86_hdiff_stencil_variant<Platform, ValueType>(args, false),
+                  m_iblocksize(args.get<int>("i-blocksize")), m_jblocksize(args.get<int>("j-blocksize")) {
+                if (m_iblocksize <= 0 || m_jblocksize <= 0)
+                    throw ERROR("invalid block size");
+                if (this->istride() != 1)
+                    throw ERROR("this variant is only compatible with unit i-stride layout");
+                if (this->halo() < 2)
+                    throw ERROR("Minimum required halo is 2");
+            }
+
+            void hdiff() override {
+                const int isize = this->isize();
+                const int jsize = this->jsize();
+                const int ksize = this->ksize();
+                // row buffers start at i = ib - 1
+                const int rowsize = m_iblocksize + 2;
+
+#pragma omp parallel
+                {
+                    std::vector<value_type> rows(6 * rowsize);
+
+#pragma omp for collapse(3) schedule(static)
+                    for (int k = 0; k < ksize; ++k) {
+                        for (int jb = 0; jb < jsize; jb += m_jblocksize) {
+                            for (int ib = 0; ib < isize; ib += m_iblocksize) {
+                                const int imax = std::min(ib + m_iblocksize, isize);
+                                const int jmax = std::min(jb + m_jblocksize, jsize);
+                                sweep(ib, imax, jb, jmax, k, rows.data(), rowsize);
+                            }
+                        }
+                    }
+                }
+            }
+
+          protected:
+            // compulsory traffic per time step: in and coeff are read, out written; lap, flx and fly never leave the
+            // row buffers
+            std::size_t touched_elements(const std::string &stencil) const override {
+                if (stencil != "hdiff")
+                    throw ERROR("unknown stencil '" + stencil + "'");
+                const std::size_t i = this->isize(), j = this->jsize(), k = this->ksize();
+                return i * j * k * 3 * this->timesteps();
+            }
+
+          private:
+            // lap of row j for i in [ib - 1, ib + n + 1)
+            void laplacian(value_type *__restrict__ lap, const int ib, const int n, const int j, const int k) {
+                const value_type *__restrict__ in = this->in();
+                constexpr int istride = 1;
+                const int jstride = this->jstride();
+                const int row = (ib - 1) * istride + j * jstride + k * this->kstride();
+#pragma omp simd
+                for (int l = 0; l < n + 2; ++l) {
+                    const int index = row + l * istride;
+                    lap[l] = 4 * in[index] -
+                             (in[index - istride] + in[index + istride] + in[index - jstride] + in[index + jstride]);
+                }
+            }
+
+            // element i of a row buffer is at (i - ib + 1)
+            void sweep(const int ib, const int imax, const int jb, const int jmax, const int k,
+                value_type *__restrict__ rows, const int rowsize) {
+                const value_type *__restrict__ in = this->in();
+                const value_type *__restrict__ coeff = this->coeff();
+                value_type *__restrict__ out = this->out();
+
+                constexpr int istride = 1;
+                const int jstride = this->jstride();
+                const int kstride = this->kstride();
+                const int n = imax - ib;
+
+                // lap of row j is kept in slot (j - jb + 1) % 3, fly of row j in slot (j - jb + 1) % 2
+                auto lap_row = [&](int j) { return rows + (j - jb + 1) % 3 * rowsize; };
+                auto fly_row = [&](int j) { return rows + (3 + (j - jb + 1) % 2) * rowsize; };
+                value_type *__restrict__ flx = rows + 5 * rowsize;
+
+                // fly of row jb - 1, needs lap of rows jb - 1 and jb
+                laplacian(lap_row(jb - 1), ib, n, jb - 1, k);
+                laplacian(lap_row(jb), ib, n, jb, k);
+                {
+                    const value_type *__restrict__ lapc = lap_row(jb - 1);
+                    const value_type *__restrict__ lapp = lap_row(jb);
+                    value_type *__restrict__ flyc = fly_row(jb - 1);
+                    const int row = ib * istride + (jb - 1) * jstride + k * kstride;
+#pragma omp simd
+                    for (int l = 0; l < n; ++l) {
+                        const int index = row + l * istride;
+                        flyc[l + 1] = lapp[l + 1] - lapc[l + 1];
+                        if (flyc[l + 1] * (in[index + jstride] - in[index]) > 0)
+                            flyc[l + 1] = 0.;
+                    }
+                }
+
+                for (int j = jb; j < jmax; ++j) {
+                    const value_type *__restrict__ lapc = lap_row(j);
+                    value_type *__restrict__ lapp = lap_row(j + 1);
+                    const value_type *__restrict__ flym = fly_row(j - 1);
+                    value_type *__restrict__ flyc = fly_row(j);
+                    laplacian(lapp, ib, n, j + 1, k);
+
+                    const int row = ib * istride + j * jstride + k * kstride;
+#pragma omp simd
+                    for (int l = -1; l < n; ++l) {
+                        const int index = row + l * istride;
+                        flx[l + 1] = lapc[l + 2] - lapc[l + 1];
+                        if (flx[l + 1] * (in[index + istride] - in[index]) > 0)
+                            flx[l + 1] = 0.;
+                    }
+
+#pragma omp simd
+                    for (int l = 0; l < n; ++l) {
+                        const int index = row + l * istride;
+                        flyc[l + 1] = lapp[l + 1] - lapc[l + 1];
+                        if (flyc[l + 1] * (in[index + jstride] - in[index]) > 0)
+                            flyc[l + 1] = 0.;
+                        out[index] = in[index] - coeff[index] * (flx[l + 1] - flx[l] + flyc[l + 1] - flym[l + 1]);
+                    }
+                }
+            }
+
+            int m_iblocksize, m_jblocksize;
+        };
+
+    } // namespace x86
+
+} // namespace platform
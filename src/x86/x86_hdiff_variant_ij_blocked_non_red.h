@@ -0,0 +1,127 @@
+#pragma once
+
+#include "x86/x86_hdiff_stencil_variant.h"
+
+namespace platform {
+
+    namespace x86 {
+
+        // port of the KNL variant: per k-level, lap, flx, fly and out are computed in separate blocked sweeps over
+        // the whole plane, so no point is computed twice; the sweeps are separated by the barriers of omp for
+        // inside a single parallel region instead of one parallel region per sweep
+        template <class Platform, class ValueType>
+        class x86_hdiff_variant_ij_blocked_non_red final : public x86_hdiff_stencil_variant<Platform, ValueType> {
+          public:
+            using value_type = ValueType;
+
+            x86_hdiff_variant_ij_blocked_non_red(const arguments_map &args)
+                : x86_hdiff_stencil_variant<Platform, ValueType>(args), m_iblocksize(args.get<int>("i-blocksize")),
+                  m_jblocksize(args.get<int>("j-blocksize")) {
+                if (m_iblocksize <= 0 || m_jblocksize <= 0)
+                    throw ERROR("invalid block size");
+                if (this->istride() != 1)
+                    throw ERROR("this variant is only compatible with unit i-stride layout");
+                if (this->halo() < 2)
+                    throw ERROR("Minimum required halo is 2");
+            }
+
+            void hdiff() override {
+                const value_type *__restrict__ in = this->in();
+                const value_type *__restrict__ coeff = this->coeff();
+                value_type *__restrict__ lap = this->lap();
+                value_type *__restrict__ flx = this->flx();
+                value_type *__restrict__ fly = this->fly();
+                value_type *__restrict__ out = this->out();
+
+                constexpr int istride = 1;
+                const int jstride = this->jstride();
+                const int kstride = this->kstride();
+                const int isize = this->isize();
+                const int jsize = this->jsize();
+                const int ksize = this->ksize();
+
+#pragma omp parallel
+                for (int k = 0; k < ksize; ++k) {
+                    // lap on [-1, isize + 1) x [-1, jsize + 1)
+#pragma omp for collapse(2)
+                    for (int jb = -1; jb < jsize + 1; jb += m_jblocksize) {
+                        for (int ib = -1; ib < isize + 1; ib += m_iblocksize) {
+                            const int imax = ib + m_iblocksize <= isize + 1 ? ib + m_iblocksize : isize + 1;
+                            const int jmax = jb + m_jblocksize <= jsize + 1 ? jb + m_jblocksize : jsize + 1;
+                            for (int j = jb; j < jmax; ++j) {
+                                const int row = j * jstride + k * kstride;
+#pragma omp simd
+                                for (int i = ib; i < imax; ++i) {
+                                    const int index = row + i * istride;
+                                    lap[index] = 4 * in[index] - (in[index - istride] + in[index + istride] +
+                                                                     in[index - jstride] + in[index + jstride]);
+                                }
+                            }
+                        }
+                    }
+
+                    // flx on [-1, isize) x [0, jsize)
+#pragma omp for collapse(2) nowait
+                    for (int jb = 0; jb < jsize; jb += m_jblocksize) {
+                        for (int ib = -1; ib < isize; ib += m_iblocksize) {
+                            const int imax = ib + m_iblocksize <= isize ? ib + m_iblocksize : isize;
+                            const int jmax = jb + m_jblocksize <= jsize ? jb + m_jblocksize : jsize;
+                            for (int j = jb; j < jmax; ++j) {
+                                const int row = j * jstride + k * kstride;
+#pragma omp simd
+                                for (int i = ib; i < imax; ++i) {
+                                    const int index = row + i * istride;
+                                    flx[index] = lap[index + istride] - lap[index];
+                                    if (flx[index] * (in[index + istride] - in[index]) > 0)
+                                        flx[index] = 0.;
+                                }
+                            }
+                        }
+                    }
+
+                    // fly on [0, isize) x [-1, jsize), independent of flx
+#pragma omp for collapse(2)
+                    for (int jb = -1; jb < jsize; jb += m_jblocksize) {
+                        for (int ib = 0; ib < isize; ib += m_iblocksize) {
+                            const int imax = ib + m_iblocksize <= isize ? ib + m_iblocksize : isize;
+                            const int jmax = jb + m_jblocksize <= jsize ? jb + m_jblocksize : jsize;
+                            for (int j = jb; j < jmax; ++j) {
+                                const int row = j * jstride + k * kstride;
+#pragma omp simd
+                                for (int i = ib; i < imax; ++i) {
+                                    const int index = row + i * istride;
+                                    fly[index] = lap[index + jstride] - lap[index];
+                                    if (fly[index] * (in[index + jstride] - in[index]) > 0)
+                                        fly[index] = 0.;
+                                }
+                            }
+                        }
+                    }
+
+                    // out on [0, isize) x [0, jsize), the next k-level does not depend on it
+#pragma omp for collapse(2) nowait
+                    for (int jb = 0; jb < jsize; jb += m_jblocksize) {
+                        for (int ib = 0; ib < isize; ib += m_iblocksize) {
+                            const int imax = ib + m_iblocksize <= isize ? ib + m_iblocksize : isize;
+                            const int jmax = jb + m_jblocksize <= jsize ? jb + m_jblocksize : jsize;
+                            for (int j = jb; j < jmax; ++j) {
+                                const int row = j * jstride + k * kstride;
+#pragma omp simd
+                                for (int i = ib; i < imax; ++i) {
+                                    const int index = row + i * istride;
+                                    out[index] = in[index] - coeff[index] * (flx[index] - flx[index - istride] +
+                                                                                fly[index] - fly[index - jstride]);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+          private:
+            int m_iblocksize, m_jblocksize;
+        };
+
+    } // namespace x86
+
+} // namespace platform
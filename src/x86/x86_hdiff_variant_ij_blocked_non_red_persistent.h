@@ -0,0 +1,190 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <omp.h>
+#include <thread>
+#include <vector>
+
+#include "x86/x86_hdiff_stencil_variant.h"
+
+namespace platform {
+
+    namespace x86 {
+
+        // non-redundant like hdiff-ij-blocked-non-red, but with a single parallel region for all k-levels and no
+        // team barriers: every thread owns a fixed contiguous range of ij-blocks and publishes per block the
+        // k-level up to which lap and the fluxes are done as epoch counters; flx and fly of a block wait only for
+        // lap of its i- and j-successor, out only for the fluxes of its i- and j-predecessor
+        template <class Platform, class ValueType>
+        class x86_hdiff_variant_ij_blocked_non_red_persistent final
+            : public x86_hdiff_stencil_variant<Platform, ValueType> {
+          public:
+            using value_type = ValueType;
+
+            x86_hdiff_variant_ij_blocked_non_red_persistent(const arguments_map &args)
+                : x86_hdiff_stencil_variant<Platform, ValueType>(args), m_iblocksize(args.get<int>("i-blocksize")),
+                  m_jblocksize(args.get<int>("j-blocksize")) {
+                if (m_iblocksize <= 0 || m_jblocksize <= 0)
+                    throw ERROR("invalid block size");
+                if (this->istride() != 1)
+                    throw ERROR("this variant is only compatible with unit i-stride layout");
+                if (this->halo() < 2)
+                    throw ERROR("Minimum required halo is 2");
+                m_iblocks = (this->isize() + m_iblocksize - 1) / m_iblocksize;
+                m_jblocks = (this->jsize() + m_jblocksize - 1) / m_jblocksize;
+                m_epochs = std::vector<block_epochs>(m_iblocks * m_jblocks);
+            }
+
+            void hdiff() override {
+                const int iblocks = m_iblocks;
+                const int blocks = m_iblocks * m_jblocks;
+                const int ksize = this->ksize();
+                for (auto &e : m_epochs) {
+                    e.lap.store(0, std::memory_order_relaxed);
+                    e.flux.store(0, std::memory_order_relaxed);
+                }
+
+#pragma omp parallel
+                {
+                    const int threads = omp_get_num_threads();
+                    const int thread = omp_get_thread_num();
+                    const int first = long(thread) * blocks / threads;
+                    const int last = long(thread + 1) * blocks / threads;
+
+                    for (int k = 0; k < ksize; ++k) {
+                        for (int b = first; b < last; ++b) {
+                            laplacian(b, k);
+                            m_epochs[b].lap.store(k + 1, std::memory_order_release);
+                        }
+
+                        for (int b = first; b < last; ++b) {
+                            if (b % iblocks + 1 < iblocks)
+                                wait(m_epochs[b + 1].lap, k + 1);
+                            if (b + iblocks < blocks)
+                                wait(m_epochs[b + iblocks].lap, k + 1);
+                            fluxes(b, k);
+                            m_epochs[b].flux.store(k + 1, std::memory_order_release);
+                        }
+
+                        for (int b = first; b < last; ++b) {
+                            if (b % iblocks > 0)
+                                wait(m_epochs[b - 1].flux, k + 1);
+                            if (b >= iblocks)
+                                wait(m_epochs[b - iblocks].flux, k + 1);
+                            update(b, k);
+                        }
+                    }
+                }
+            }
+
+          private:
+            // padded to keep the counters of different blocks on separate cache lines
+            struct block_epochs {
+                std::atomic<int> lap, flux;
+                char padding[64 - 2 * sizeof(std::atomic<int>)];
+            };
+
+            static void wait(const std::atomic<int> &epoch, const int value) {
+                while (epoch.load(std::memory_order_acquire) < value)
+                    std::this_thread::yield();
+            }
+
+            // block b covers [ib, imax) x [jb, jmax), blocks at the domain boundary also own the boundary lines of
+            // lap, flx and fly outside the domain
+            void block_range(const int b, int &ib, int &imax, int &jb, int &jmax) const {
+                ib = b % m_iblocks * m_iblocksize;
+                jb = b / m_iblocks * m_jblocksize;
+                imax = std::min(ib + m_iblocksize, this->isize());
+                jmax = std::min(jb + m_jblocksize, this->jsize());
+            }
+
+            void laplacian(const int b, const int k) {
+                const value_type *__restrict__ in = this->in();
+                value_type *__restrict__ lap = this->lap();
+                constexpr int istride = 1;
+                const int jstride = this->jstride();
+                const int kstride = this->kstride();
+                int ib, imax, jb, jmax;
+                block_range(b, ib, imax, jb, jmax);
+                const int ilo = ib == 0 ? -1 : ib, ihi = imax == this->isize() ? imax + 1 : imax;
+                const int jlo = jb == 0 ? -1 : jb, jhi = jmax == this->jsize() ? jmax + 1 : jmax;
+
+                for (int j = jlo; j < jhi; ++j) {
+                    const int row = j * jstride + k * kstride;
+#pragma omp simd
+                    for (int i = ilo; i < ihi; ++i) {
+                        const int index = row + i * istride;
+                        lap[index] = 4 * in[index] - (in[index - istride] + in[index + istride] + in[index - jstride] +
+                                                         in[index + jstride]);
+                    }
+                }
+            }
+
+            void fluxes(const int b, const int k) {
+                const value_type *__restrict__ in = this->in();
+                const value_type *__restrict__ lap = this->lap();
+                value_type *__restrict__ flx = this->flx();
+                value_type *__restrict__ fly = this->fly();
+                constexpr int istride = 1;
+                const int jstride = this->jstride();
+                const int kstride = this->kstride();
+                int ib, imax, jb, jmax;
+                block_range(b, ib, imax, jb, jmax);
+                const int ilo = ib == 0 ? -1 : ib;
+                const int jlo = jb == 0 ? -1 : jb;
+
+                for (int j = jb; j < jmax; ++j) {
+                    const int row = j * jstride + k * kstride;
+#pragma omp simd
+                    for (int i = ilo; i < imax; ++i) {
+                        const int index = row + i * istride;
+                        flx[index] = lap[index + istride] - lap[index];
+                        if (flx[index] * (in[index + istride] - in[index]) > 0)
+                            flx[index] = 0.;
+                    }
+                }
+
+                for (int j = jlo; j < jmax; ++j) {
+                    const int row = j * jstride + k * kstride;
+#pragma omp simd
+                    for (int i = ib; i < imax; ++i) {
+                        const int index = row + i * istride;
+                        fly[index] = lap[index + jstride] - lap[index];
+                        if (fly[index] * (in[index + jstride] - in[index]) > 0)
+                            fly[index] = 0.;
+                    }
+                }
+            }
+
+            void update(const int b, const int k) {
+                const value_type *__restrict__ in = this->in();
+                const value_type *__restrict__ coeff = this->coeff();
+                const value_type *__restrict__ flx = this->flx();
+                const value_type *__restrict__ fly = this->fly();
+                value_type *__restrict__ out = this->out();
+                constexpr int istride = 1;
+                const int jstride = this->jstride();
+                const int kstride = this->kstride();
+                int ib, imax, jb, jmax;
+                block_range(b, ib, imax, jb, jmax);
+
+                for (int j = jb; j < jmax; ++j) {
+                    const int row = j * jstride + k * kstride;
+#pragma omp simd
+                    for (int i = ib; i < imax; ++i) {
+                        const int index = row + i * istride;
+                        out[index] = in[index] - coeff[index] * (flx[index] - flx[index - istride] + fly[index] -
+                                                                    fly[index - jstride]);
+                    }
+                }
+            }
+
+            int m_iblocksize, m_jblocksize;
+            int m_iblocks, m_jblocks;
+            std::vector<block_epochs> m_epochs;
+        };
+
+    } // namespace x86
+
+} // namespace platform
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <vector>
+
+#include "x86/x86_hdiff_stencil_variant.h"
+
+namespace platform {
+
+    namespace x86 {
+
+        // like the private-halo variant, but instead of block-private temporaries for the whole domain every thread
+        // owns a single (i-blocksize + 2 * halo) x (j-blocksize + 2 * halo) tile of lap, flx and fly that is reused
+        // for all blocks and k-levels it processes, so the temporaries stay in L1/L2
+        template <class Platform, class ValueType>
+        class x86_hdiff_variant_ij_blocked_thread_private final
+            : public x86_hdiff_stencil_variant<Platform, ValueType> {
+          public:
+            using value_type = ValueType;
+            using allocator = typename x86_hdiff_stencil_variant<Platform, ValueType>::allocator;
+
+            x86_hdiff_variant_ij_blocked_thread_private(const arguments_map &args)
+                : x86_hdiff_stencil_variant<Platform, ValueType>(args, false),
+                  m_iblocksize(args.get<int>("i-blocksize")), m_jblocksize(args.get<int>("j-blocksize")) {
+                if (m_iblocksize <= 0 || m_jblocksize <= 0)
+                    throw ERROR("invalid block size");
+                if (this->istride() != 1)
+                    throw ERROR("this variant is only compatible with unit i-stride layout");
+                if (this->halo() < 2)
+                    throw ERROR("Minimum required halo is 2");
+                // tile strides, rows padded to the alignment
+                const int isize_tmp = m_iblocksize + 2 * this->halo();
+                m_jstride_tmp = (isize_tmp + this->alignment() - 1) / this->alignment() * this->alignment();
+                m_tile_size = m_jstride_tmp * (m_jblocksize + 2 * this->halo());
+            }
+
+            void hdiff() override {
+                const value_type *__restrict__ in = this->in();
+                const value_type *__restrict__ coeff = this->coeff();
+                value_type *__restrict__ out = this->out();
+
+                constexpr int istride = 1;
+                constexpr int istride_tmp = 1;
+                const int jstride = this->jstride();
+                const int kstride = this->kstride();
+                const int jstride_tmp = m_jstride_tmp;
+                const int h = this->halo();
+                const int isize = this->isize();
+                const int jsize = this->jsize();
+                const int ksize = this->ksize();
+
+#pragma omp parallel
+                {
+                    std::vector<value_type, allocator> lap_tile(m_tile_size), flx_tile(m_tile_size),
+                        fly_tile(m_tile_size);
+                    // element (0, 0) of the block is at (h, h) in the tiles
+                    value_type *__restrict__ lap = lap_tile.data() + h * istride_tmp + h * jstride_tmp;
+                    value_type *__restrict__ flx = flx_tile.data() + h * istride_tmp + h * jstride_tmp;
+                    value_type *__restrict__ fly = fly_tile.data() + h * istride_tmp + h * jstride_tmp;
+
+#pragma omp for collapse(3)
+                    for (int k = 0; k < ksize; ++k) {
+                        for (int jb = 0; jb < jsize; jb += m_jblocksize) {
+                            for (int ib = 0; ib < isize; ib += m_iblocksize) {
+                                const int imax = ib + m_iblocksize <= isize ? m_iblocksize : isize - ib;
+                                const int jmax = jb + m_jblocksize <= jsize ? m_jblocksize : jsize - jb;
+                                const int index = ib * istride + jb * jstride + k * kstride;
+
+                                for (int j = -1; j < jmax + 1; ++j) {
+#pragma omp simd
+                                    for (int i = -1; i < imax + 1; ++i) {
+                                        const int index_in = index + i * istride + j * jstride;
+                                        lap[i * istride_tmp + j * jstride_tmp] =
+                                            4 * in[index_in] - (in[index_in - istride] + in[index_in + istride] +
+                                                                   in[index_in - jstride] + in[index_in + jstride]);
+                                    }
+                                }
+
+                                for (int j = 0; j < jmax; ++j) {
+#pragma omp simd
+                                    for (int i = -1; i < imax; ++i) {
+                                        const int index_in = index + i * istride + j * jstride;
+                                        const int index_tmp = i * istride_tmp + j * jstride_tmp;
+                                        flx[index_tmp] = lap[index_tmp + istride_tmp] - lap[index_tmp];
+                                        if (flx[index_tmp] * (in[index_in + istride] - in[index_in]) > 0)
+                                            flx[index_tmp] = 0.;
+                                    }
+                                }
+
+                                for (int j = -1; j < jmax; ++j) {
+#pragma omp simd
+                                    for (int i = 0; i < imax; ++i) {
+                                        const int index_in = index + i * istride + j * jstride;
+                                        const int index_tmp = i * istride_tmp + j * jstride_tmp;
+                                        fly[index_tmp] = lap[index_tmp + jstride_tmp] - lap[index_tmp];
+                                        if (fly[index_tmp] * (in[index_in + jstride] - in[index_in]) > 0)
+                                            fly[index_tmp] = 0.;
+                                    }
+                                }
+
+                                for (int j = 0; j < jmax; ++j) {
+#pragma omp simd
+                                    for (int i = 0; i < imax; ++i) {
+                                        const int index_out = index + i * istride + j * jstride;
+                                        const int index_tmp = i * istride_tmp + j * jstride_tmp;
+                                        out[index_out] =
+                                            in[index_out] -
+                                            coeff[index_out] * (flx[index_tmp] - flx[index_tmp - istride_tmp] +
+                                                                   fly[index_tmp] - fly[index_tmp - jstride_tmp]);
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+          protected:
+            // in and coeff are read, out written; the temporaries stay in the thread-private tiles
+            std::size_t touched_elements(const std::string &stencil) const override {
+                if (stencil != "hdiff")
+                    throw ERROR("unknown stencil '" + stencil + "'");
+                const std::size_t i = this->isize(), j = this->jsize(), k = this->ksize();
+                return i * j * k * 3 * this->timesteps();
+            }
+
+          private:
+            int m_iblocksize, m_jblocksize;
+            int m_jstride_tmp, m_tile_size;
+        };
+
+    } // namespace x86
+
+} // namespace platform
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "x86/x86_hdiff_stencil_variant.h"
+
+namespace platform {
+
+    namespace x86 {
+
+        // hdiff-ij-blocked-non-red with the lap sweep computing unroll-j rows per inner iteration: the unroll-j + 2
+        // centre values of in of a column are loaded once and shared by the neighbouring rows, so lap needs
+        // 3 * unroll-j + 2 instead of 5 * unroll-j loads
+        template <class Platform, class ValueType>
+        class x86_hdiff_variant_ij_blocked_unrolled final : public x86_hdiff_stencil_variant<Platform, ValueType> {
+          public:
+            using value_type = ValueType;
+
+            x86_hdiff_variant_ij_blocked_unrolled(const arguments_map &args)
+                : x86_hdiff_stencil_variant<Platform, ValueType>(args), m_iblocksize(args.get<int>("i-blocksize")),
+                  m_jblocksize(args.get<int>("j-blocksize")), m_unroll(args.get<int>("unroll-j")) {
+                if (m_iblocksize <= 0 || m_jblocksize <= 0)
+                    throw ERROR("invalid block size");
+                if (m_unroll <= 0)
+                    throw ERROR("invalid unroll-j");
+                if (this->istride() != 1)
+                    throw ERROR("this variant is only compatible with unit i-stride layout");
+                if (this->halo() < 2)
+                    throw ERROR("Minimum required halo is 2");
+            }
+
+            void hdiff() override {
+                const value_type *__restrict__ in = this->in();
+                const value_type *__restrict__ coeff = this->coeff();
+                value_type *__restrict__ lap = this->lap();
+                value_type *__restrict__ flx = this->flx();
+                value_type *__restrict__ fly = this->fly();
+                value_type *__restrict__ out = this->out();
+
+                constexpr int istride = 1;
+                const int jstride = this->jstride();
+                const int kstride = this->kstride();
+                const int isize = this->isize();
+                const int jsize = this->jsize();
+                const int ksize = this->ksize();
+                const int unroll = m_unroll;
+
+#pragma omp parallel
+                for (int k = 0; k < ksize; ++k) {
+                    // lap on [-1, isize + 1) x [-1, jsize + 1)
+#pragma omp for collapse(2)
+                    for (int jb = -1; jb < jsize + 1; jb += m_jblocksize) {
+                        for (int ib = -1; ib < isize + 1; ib += m_iblocksize) {
+                            const int imax = ib + m_iblocksize <= isize + 1 ? ib + m_iblocksize : isize + 1;
+                            const int jmax = jb + m_jblocksize <= jsize + 1 ? jb + m_jblocksize : jsize + 1;
+                            int j = jb;
+                            // full groups of unroll rows, the remaining rows one by one
+                            for (; j + unroll <= jmax; j += unroll)
+                                lap_rows(in, lap, j * jstride + k * kstride, ib, imax, jstride, unroll);
+                            for (; j < jmax; ++j)
+                                lap_rows<1>(in, lap, j * jstride + k * kstride, ib, imax, jstride);
+                        }
+                    }
+
+                    // flx on [-1, isize) x [0, jsize)
+#pragma omp for collapse(2) nowait
+                    for (int jb = 0; jb < jsize; jb += m_jblocksize) {
+                        for (int ib = -1; ib < isize; ib += m_iblocksize) {
+                            const int imax = ib + m_iblocksize <= isize ? ib + m_iblocksize : isize;
+                            const int jmax = jb + m_jblocksize <= jsize ? jb + m_jblocksize : jsize;
+                            for (int j = jb; j < jmax; ++j) {
+                                const int row = j * jstride + k * kstride;
+#pragma omp simd
+                                for (int i = ib; i < imax; ++i) {
+                                    const int index = row + i * istride;
+                                    flx[index] = lap[index + istride] - lap[index];
+                                    if (flx[index] * (in[index + istride] - in[index]) > 0)
+                                        flx[index] = 0.;
+                                }
+                            }
+                        }
+                    }
+
+                    // fly on [0, isize) x [-1, jsize), independent of flx
+#pragma omp for collapse(2)
+                    for (int jb = -1; jb < jsize; jb += m_jblocksize) {
+                        for (int ib = 0; ib < isize; ib += m_iblocksize) {
+                            const int imax = ib + m_iblocksize <= isize ? ib + m_iblocksize : isize;
+                            const int jmax = jb + m_jblocksize <= jsize ? jb + m_jblocksize : jsize;
+                            for (int j = jb; j < jmax; ++j) {
+                                const int row = j * jstride + k * kstride;
+#pragma omp simd
+                                for (int i = ib; i < imax; ++i) {
+                                    const int index = row + i * istride;
+                                    fly[index] = lap[index + jstride] - lap[index];
+                                    if (fly[index] * (in[index + jstride] - in[index]) > 0)
+                                        fly[index] = 0.;
+                                }
+                            }
+                        }
+                    }
+
+                    // out on [0, isize) x [0, jsize), the next k-level does not depend on it
+#pragma omp for collapse(2) nowait
+                    for (int jb = 0; jb < jsize; jb += m_jblocksize) {
+                        for (int ib = 0; ib < isize; ib += m_iblocksize) {
+                            const int imax = ib + m_iblocksize <= isize ? ib + m_iblocksize : isize;
+                            const int jmax = jb + m_jblocksize <= jsize ? jb + m_jblocksize : jsize;
+                            for (int j = jb; j < jmax; ++j) {
+                                const int row = j * jstride + k * kstride;
+#pragma omp simd
+                                for (int i = ib; i < imax; ++i) {
+                                    const int index = row + i * istride;
+                                    out[index] = in[index] - coeff[index] * (flx[index] - flx[index - istride] +
+                                                                                fly[index] - fly[index - jstride]);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+          private:
+            static void lap_rows(const value_type *__restrict__ in,
+                value_type *__restrict__ lap,
+                int row,
+                const int ib,
+                const int imax,
+                const int jstride,
+                int unroll) {
+                // unroll values above 8 run as repeated groups of 8, the rest as groups of 4, 2 and 1
+                for (; unroll >= 8; unroll -= 8, row += 8 * jstride)
+                    lap_rows<8>(in, lap, row, ib, imax, jstride);
+                if (unroll & 4) {
+                    lap_rows<4>(in, lap, row, ib, imax, jstride);
+                    row += 4 * jstride;
+                }
+                if (unroll & 2) {
+                    lap_rows<2>(in, lap, row, ib, imax, jstride);
+                    row += 2 * jstride;
+                }
+                if (unroll & 1)
+                    lap_rows<1>(in, lap, row, ib, imax, jstride);
+            }
+
+            // lap on rows row, row + jstride, ..., row + (UnrollJ - 1) * jstride
+            template <int UnrollJ>
+            static void lap_rows(const value_type *__restrict__ in,
+                value_type *__restrict__ lap,
+                const int row,
+                const int ib,
+                const int imax,
+                const int jstride) {
+                constexpr int istride = 1;
+#pragma omp simd
+                for (int i = ib; i < imax; ++i) {
+                    const int index = row + i * istride;
+                    value_type c[UnrollJ + 2];
+                    for (int u = 0; u < UnrollJ + 2; ++u)
+                        c[u] = in[index + (u - 1) * jstride];
+                    for (int u = 0; u < UnrollJ; ++u) {
+                        const int n = index + u * jstride;
+                        lap[n] = 4 * c[u + 1] - (in[n - istride] + in[n + istride] + c[u] + c[u + 2]);
+                    }
+                }
+            }
+
+            int m_iblocksize, m_jblocksize, m_unroll;
+        };
+
+    } // namespace x86
+
+} // namespace platform
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#include "x86/x86_hdiff_stencil_variant.h"
+
+namespace platform {
+
+    namespace x86 {
+
+        // ij-blocked hdiff with separate types for the fields in, coeff and out (ValueType) and the intermediates
+        // lap, flx and fly (TempType), e.g. double fields with float temporaries halve the temporary traffic; the
+        // sums are computed in ValueType and only rounded when stored; verify reports the maximum pointwise and
+        // field-relative errors of out against the reference, which is computed entirely in ValueType, in the notes
+        // of the results
+        template <class Platform, class ValueType, class TempType>
+        class x86_hdiff_variant_mixed_precision final : public x86_hdiff_stencil_variant<Platform, ValueType> {
+          public:
+            using value_type = ValueType;
+            using temp_type = TempType;
+            using temp_allocator = typename Platform::template allocator<temp_type>;
+
+            x86_hdiff_variant_mixed_precision(const arguments_map &args)
+                : x86_hdiff_stencil_variant<Platform, ValueType>(args, false),
+                  m_iblocksize(args.get<int>("i-blocksize")), m_jblocksize(args.get<int>("j-blocksize")),
+                  m_lap_tmp(this->storage_size()), m_flx_tmp(this->storage_size()), m_fly_tmp(this->storage_size()) {
+                if (m_iblocksize <= 0 || m_jblocksize <= 0)
+                    throw ERROR("invalid block size");
+                if (this->istride() != 1)
+                    throw ERROR("this variant is only compatible with unit i-stride layout");
+                if (this->halo() < 2)
+                    throw ERROR("Minimum required halo is 2");
+            }
+
+            void hdiff() override {
+                const value_type *__restrict__ in = this->in();
+                const value_type *__restrict__ coeff = this->coeff();
+                value_type *__restrict__ out = this->out();
+                temp_type *__restrict__ lap = m_lap_tmp.data() + this->zero_offset();
+                temp_type *__restrict__ flx = m_flx_tmp.data() + this->zero_offset();
+                temp_type *__restrict__ fly = m_fly_tmp.data() + this->zero_offset();
+
+                constexpr int istride = 1;
+                const int jstride = this->jstride();
+                const int kstride = this->kstride();
+                const int isize = this->isize();
+                const int jsize = this->jsize();
+                const int ksize = this->ksize();
+
+#pragma omp parallel for collapse(3)
+                for (int k = 0; k < ksize; ++k) {
+                    for (int jb = 0; jb < jsize; jb += m_jblocksize) {
+                        for (int ib = 0; ib < isize; ib += m_iblocksize) {
+                            const int imax = ib + m_iblocksize <= isize ? m_iblocksize : isize - ib;
+                            const int jmax = jb + m_jblocksize <= jsize ? m_jblocksize : jsize - jb;
+                            const int index = ib * istride + jb * jstride + k * kstride;
+
+                            for (int j = -1; j < jmax + 1; ++j) {
+#pragma omp simd
+                                for (int i = -1; i < imax + 1; ++i) {
+                                    const int c = index + i * istride + j * jstride;
+                                    lap[c] = temp_type(4 * in[c] - (in[c - istride] + in[c + istride] +
+                                                                       in[c - jstride] + in[c + jstride]));
+                                }
+                            }
+
+                            for (int j = 0; j < jmax; ++j) {
+#pragma omp simd
+                                for (int i = -1; i < imax; ++i) {
+                                    const int c = index + i * istride + j * jstride;
+                                    flx[c] = lap[c + istride] - lap[c];
+                                    if (flx[c] * (in[c + istride] - in[c]) > 0)
+                                        flx[c] = 0.;
+                                }
+                            }
+
+                            for (int j = -1; j < jmax; ++j) {
+#pragma omp simd
+                                for (int i = 0; i < imax; ++i) {
+                                    const int c = index + i * istride + j * jstride;
+                                    fly[c] = lap[c + jstride] - lap[c];
+                                    if (fly[c] * (in[c + jstride] - in[c]) > 0)
+                                        fly[c] = 0.;
+                                }
+                            }
+
+                            for (int j = 0; j < jmax; ++j) {
+#pragma omp simd
+                                for (int i = 0; i < imax; ++i) {
+                                    const int c = index + i * istride + j * jstride;
+                                    out[c] = in[c] - coeff[c] * (value_type(flx[c]) - value_type(flx[c - istride]) +
+                                                                    value_type(fly[c]) - value_type(fly[c - jstride]));
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+          protected:
+            bool verify(const std::string &stencil) override {
+                const bool success = x86_hdiff_stencil_variant<Platform, ValueType>::verify(stencil);
+
+                const value_type *out = this->out();
+                const value_type *out_ref = this->out_ref();
+                const int isize = this->isize();
+                const int jsize = this->jsize();
+                const int ksize = this->ksize();
+                double max_error = 0, max_abs_error = 0, max_abs = 0;
+#pragma omp parallel for collapse(3) reduction(max : max_error, max_abs_error, max_abs)
+                for (int k = 0; k < ksize; ++k)
+                    for (int j = 0; j < jsize; ++j)
+                        for (int i = 0; i < isize; ++i) {
+                            const double a = out_ref[this->index(i, j, k)];
+                            const double b = out[this->index(i, j, k)];
+                            const double scale = std::max(std::abs(a), std::abs(b));
+                            if (scale > 0)
+                                max_error = std::max(max_error, std::abs(a - b) / scale);
+                            max_abs_error = std::max(max_abs_error, std::abs(a - b));
+                            max_abs = std::max(max_abs, std::abs(a));
+                        }
+                const double field_error = max_abs > 0 ? max_abs_error / max_abs : max_abs_error;
+                std::stringstream note;
+                note << stencil << " with " << (sizeof(temp_type) * 8) << "-bit temporaries: max. relative error "
+                     << max_error << ", max. error relative to max. |out| " << field_error;
+                m_notes[stencil] = note.str();
+
+                // where out cancels to almost zero, the rounding of reduced-precision temporaries exceeds the pointwise
+                // tolerance of the reference check, so they are only checked relative to the field maximum
+                if (sizeof(temp_type) < sizeof(value_type))
+                    return field_error <= 1e-3;
+                return success;
+            }
+
+            std::vector<std::string> notes(const std::string &stencil) const override {
+                const auto note = m_notes.find(stencil);
+                if (note == m_notes.end())
+                    return {};
+                return {note->second};
+            }
+
+            // like the base estimate, but lap, flx and fly count with sizeof(temp_type) bytes, expressed in elements
+            // of value_type
+            std::size_t touched_elements(const std::string &stencil) const override {
+                if (stencil != "hdiff")
+                    throw ERROR("unknown stencil '" + stencil + "'");
+                const std::size_t i = this->isize(), j = this->jsize(), k = this->ksize();
+                return i * j * k * (3 * sizeof(value_type) + 3 * sizeof(temp_type)) / sizeof(value_type) *
+                       this->timesteps();
+            }
+
+          private:
+            int m_iblocksize, m_jblocksize;
+            std::vector<temp_type, temp_allocator> m_lap_tmp, m_flx_tmp, m_fly_tmp;
+            std::map<std::string, std::string> m_notes;
+        };
+
+    } // namespace x86
+
+} // namespace platform
@@ -0,0 +1,295 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "x86/x86_hdiff_stencil_variant.h"
+#include "x86/x86_simd.h"
+
+namespace platform {
+
+    namespace x86 {
+
+        // single sweep over j like hdiff-ij-blocked-fused, but with explicit vector code: per row, one loop computes
+        // the next lap row, a second one both fluxes, the limiters and out, so flx never goes to memory; the flux
+        // limiter is a branch-free compare and select; stencil hdiff-branchy runs the same sweep as omp simd loops
+        // with the branchy limiter of the other variants to measure what the limiter costs
+        template <class Platform, class ValueType>
+        class x86_hdiff_variant_simd final : public x86_hdiff_stencil_variant<Platform, ValueType> {
+          public:
+            using value_type = ValueType;
+            using vec = simd<value_type>;
+            using vtype = typename vec::type;
+            using mask_type = typename vec::mask_type;
+
+            x86_hdiff_variant_simd(const arguments_map &args)
+                : x86_hdiff_stencil_variant<Platform, ValueType>(args, false),
+                  m_iblocksize(args.get<int>("i-blocksize")), m_jblocksize(args.get<int>("j-blocksize")),
+                  m_branchy(false) {
+                if (m_iblocksize <= 0 || m_jblocksize <= 0)
+                    throw ERROR("invalid block size");
+                if (this->istride() != 1)
+                    throw ERROR("this variant is only compatible with unit i-stride layout");
+                if (this->halo() < 2)
+                    throw ERROR("Minimum required halo is 2");
+            }
+
+            std::vector<std::string> stencil_list() const override { return {"hdiff", "hdiff-branchy"}; }
+
+            void hdiff() override {
+                const int isize = this->isize();
+                const int jsize = this->jsize();
+                const int ksize = this->ksize();
+                // row buffers start at i = ib - 1 and are padded to full vectors
+                const int rowsize = (m_iblocksize + 2 + vec::width - 1) / vec::width * vec::width;
+
+#pragma omp parallel
+                {
+                    // lap and fly rows, plus flx and flxm rows for sweep_branchy
+                    std::vector<value_type> rows(7 * rowsize);
+
+#pragma omp for collapse(3) schedule(static)
+                    for (int k = 0; k < ksize; ++k) {
+                        for (int jb = 0; jb < jsize; jb += m_jblocksize) {
+                            for (int ib = 0; ib < isize; ib += m_iblocksize) {
+                                const int imax = std::min(ib + m_iblocksize, isize);
+                                const int jmax = std::min(jb + m_jblocksize, jsize);
+                                if (m_branchy)
+                                    sweep_branchy(ib, imax, jb, jmax, k, rows.data(), rowsize);
+                                else
+                                    sweep(ib, imax, jb, jmax, k, rows.data(), rowsize);
+                            }
+                        }
+                    }
+                }
+            }
+
+          protected:
+            std::function<void()> stencil_function(const std::string &stencil) override {
+                if (stencil == "hdiff-branchy") {
+                    return [this]() {
+                        m_branchy = true;
+                        this->hdiff_timesteps();
+                        m_branchy = false;
+                    };
+                }
+                return x86_hdiff_stencil_variant<Platform, ValueType>::stencil_function(stencil);
+            }
+
+            bool verify(const std::string &stencil) override {
+                return x86_hdiff_stencil_variant<Platform, ValueType>::verify(
+                    stencil == "hdiff-branchy" ? "hdiff" : stencil);
+            }
+
+            // both stencils keep lap, flx and fly in the row buffers, only in, coeff and out are touched in memory
+            std::size_t touched_elements(const std::string &stencil) const override {
+                if (stencil != "hdiff" && stencil != "hdiff-branchy")
+                    throw ERROR("unknown stencil '" + stencil + "'");
+                const std::size_t i = this->isize(), j = this->jsize(), k = this->ksize();
+                return i * j * k * 3 * this->timesteps();
+            }
+
+          private:
+            template <bool Masked>
+            static vtype load(mask_type mask, const value_type *p) {
+                return Masked ? vec::maskz_loadu(mask, p) : vec::loadu(p);
+            }
+
+            template <bool Masked>
+            static void store(mask_type mask, value_type *p, vtype v) {
+                if (Masked)
+                    vec::mask_storeu(p, mask, v);
+                else
+                    vec::storeu(p, v);
+            }
+
+            // lap for the lanes [l, l + width) of a row buffer, element l is at in[index + l - 1]
+            template <bool Masked>
+            static void laplacian(value_type *__restrict__ lap,
+                const value_type *__restrict__ in,
+                const int index,
+                const int jstride,
+                const int l,
+                const mask_type mask) {
+                const vtype four = vec::set1(4);
+                const value_type *c = in + index + l - 1;
+                vtype neighbours = vec::add(vec::add(vec::add(load<Masked>(mask, c - 1), load<Masked>(mask, c + 1)),
+                                                load<Masked>(mask, c - jstride)),
+                    load<Masked>(mask, c + jstride));
+                store<Masked>(mask, lap + l, vec::sub(vec::mul(four, load<Masked>(mask, c)), neighbours));
+            }
+
+            // fluxes, limiters and out for the lanes [l, l + width) of row j, the row buffers hold element i at
+            // (i - ib + 1), the fly of row j goes to flyc
+            template <bool Masked>
+            static void update(const value_type *__restrict__ in,
+                const value_type *__restrict__ coeff,
+                value_type *__restrict__ out,
+                const value_type *__restrict__ lapc,
+                const value_type *__restrict__ lapp,
+                const value_type *__restrict__ flym,
+                value_type *__restrict__ flyc,
+                const int index,
+                const int jstride,
+                const int l,
+                const mask_type mask) {
+                const value_type *c = in + index + l;
+                const vtype inc = load<Masked>(mask, c);
+                const vtype inm = load<Masked>(mask, c - 1);
+                const vtype inp = load<Masked>(mask, c + 1);
+                const vtype lapm = load<Masked>(mask, lapc + l);
+                const vtype lap = load<Masked>(mask, lapc + l + 1);
+                const vtype lapi = load<Masked>(mask, lapc + l + 2);
+
+                vtype flx = vec::sub(lapi, lap);
+                flx = vec::zero_where_positive(vec::mul(flx, vec::sub(inp, inc)), flx);
+                vtype flxm = vec::sub(lap, lapm);
+                flxm = vec::zero_where_positive(vec::mul(flxm, vec::sub(inc, inm)), flxm);
+                vtype fly = vec::sub(load<Masked>(mask, lapp + l + 1), lap);
+                fly = vec::zero_where_positive(vec::mul(fly, vec::sub(load<Masked>(mask, c + jstride), inc)), fly);
+                store<Masked>(mask, flyc + l + 1, fly);
+
+                const vtype diff =
+                    vec::sub(vec::add(vec::sub(flx, flxm), fly), load<Masked>(mask, flym + l + 1));
+                store<Masked>(mask, out + index + l, vec::fnmadd(load<Masked>(mask, coeff + index + l), diff, inc));
+            }
+
+            void sweep(const int ib,
+                const int imax,
+                const int jb,
+                const int jmax,
+                const int k,
+                value_type *__restrict__ rows,
+                const int rowsize) {
+                constexpr int width = vec::width;
+                const value_type *__restrict__ in = this->in();
+                const value_type *__restrict__ coeff = this->coeff();
+                value_type *__restrict__ out = this->out();
+                const int jstride = this->jstride();
+                const int kstride = this->kstride();
+                const int n = imax - ib;
+                const mask_type lap_mask = vec::mask((n + 2) % width);
+                const mask_type mask = vec::mask(n % width);
+
+                // lap of row j is kept in slot (j - jb + 1) % 3, fly of row j in slot (j - jb + 1) % 2
+                auto lap_row = [&](int j) { return rows + (j - jb + 1) % 3 * rowsize; };
+                auto fly_row = [&](int j) { return rows + (3 + (j - jb + 1) % 2) * rowsize; };
+
+                auto laplacian_row = [&](int j) {
+                    value_type *lap = lap_row(j);
+                    const int index = ib + j * jstride + k * kstride;
+                    int l = 0;
+                    for (; l + width <= n + 2; l += width)
+                        laplacian<false>(lap, in, index, jstride, l, lap_mask);
+                    if (l < n + 2)
+                        laplacian<true>(lap, in, index, jstride, l, lap_mask);
+                };
+
+                laplacian_row(jb - 1);
+                laplacian_row(jb);
+                {
+                    // fly of row jb - 1
+                    const value_type *lapc = lap_row(jb - 1);
+                    const value_type *lapp = lap_row(jb);
+                    value_type *flyc = fly_row(jb - 1);
+                    const int index = ib + (jb - 1) * jstride + k * kstride;
+                    for (int l = 0; l < n; ++l) {
+                        const value_type fly = lapp[l + 1] - lapc[l + 1];
+                        flyc[l + 1] = fly * (in[index + l + jstride] - in[index + l]) > 0 ? 0 : fly;
+                    }
+                }
+
+                for (int j = jb; j < jmax; ++j) {
+                    laplacian_row(j + 1);
+                    const value_type *lapc = lap_row(j);
+                    const value_type *lapp = lap_row(j + 1);
+                    const value_type *flym = fly_row(j - 1);
+                    value_type *flyc = fly_row(j);
+                    const int index = ib + j * jstride + k * kstride;
+                    int l = 0;
+                    for (; l + width <= n; l += width)
+                        update<false>(in, coeff, out, lapc, lapp, flym, flyc, index, jstride, l, mask);
+                    if (l < n)
+                        update<true>(in, coeff, out, lapc, lapp, flym, flyc, index, jstride, l, mask);
+                }
+            }
+
+            // same sweep as vectorized loops, with the limiter as a branch like in the other hdiff variants; as in
+            // those, the limited fluxes are stored and then conditionally zeroed, with a branch on locals GCC does
+            // not if-convert the loop under the default -ftrapping-math
+            void sweep_branchy(const int ib,
+                const int imax,
+                const int jb,
+                const int jmax,
+                const int k,
+                value_type *__restrict__ rows,
+                const int rowsize) {
+                const value_type *__restrict__ in = this->in();
+                const value_type *__restrict__ coeff = this->coeff();
+                value_type *__restrict__ out = this->out();
+                constexpr int istride = 1;
+                const int jstride = this->jstride();
+                const int kstride = this->kstride();
+                const int n = imax - ib;
+
+                auto lap_row = [&](int j) { return rows + (j - jb + 1) % 3 * rowsize; };
+                auto fly_row = [&](int j) { return rows + (3 + (j - jb + 1) % 2) * rowsize; };
+
+                auto laplacian_row = [&](int j) {
+                    value_type *lap = lap_row(j);
+                    const int index = ib - 1 + j * jstride + k * kstride;
+#pragma omp simd
+                    for (int l = 0; l < n + 2; ++l) {
+                        const int c = index + l;
+                        lap[l] = 4 * in[c] - (in[c - istride] + in[c + istride] + in[c - jstride] + in[c + jstride]);
+                    }
+                };
+
+                laplacian_row(jb - 1);
+                laplacian_row(jb);
+                {
+                    const value_type *lapc = lap_row(jb - 1);
+                    const value_type *lapp = lap_row(jb);
+                    value_type *flyc = fly_row(jb - 1);
+                    const int index = ib + (jb - 1) * jstride + k * kstride;
+#pragma omp simd
+                    for (int l = 0; l < n; ++l) {
+                        flyc[l + 1] = lapp[l + 1] - lapc[l + 1];
+                        if (flyc[l + 1] * (in[index + l + jstride] - in[index + l]) > 0)
+                            flyc[l + 1] = 0.;
+                    }
+                }
+
+                value_type *flx = rows + 5 * rowsize;
+                value_type *flxm = rows + 6 * rowsize;
+                for (int j = jb; j < jmax; ++j) {
+                    laplacian_row(j + 1);
+                    const value_type *lapc = lap_row(j);
+                    const value_type *lapp = lap_row(j + 1);
+                    const value_type *flym = fly_row(j - 1);
+                    value_type *flyc = fly_row(j);
+                    const int index = ib + j * jstride + k * kstride;
+#pragma omp simd
+                    for (int l = 0; l < n; ++l) {
+                        const int c = index + l;
+                        flx[l] = lapc[l + 2] - lapc[l + 1];
+                        if (flx[l] * (in[c + istride] - in[c]) > 0)
+                            flx[l] = 0.;
+                        flxm[l] = lapc[l + 1] - lapc[l];
+                        if (flxm[l] * (in[c] - in[c - istride]) > 0)
+                            flxm[l] = 0.;
+                        flyc[l + 1] = lapp[l + 1] - lapc[l + 1];
+                        if (flyc[l + 1] * (in[c + jstride] - in[c]) > 0)
+                            flyc[l + 1] = 0.;
+                        out[c] = in[c] - coeff[c] * (flx[l] - flxm[l] + flyc[l + 1] - flym[l + 1]);
+                    }
+                }
+            }
+
+            int m_iblocksize, m_jblocksize;
+            bool m_branchy;
+        };
+
+    } // namespace x86
+
+} // namespace platform
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "stage_graph.h"
+#include "x86/x86_hdiff_stencil_variant.h"
+
+namespace platform {
+
+    namespace x86 {
+
+        // hdiff as a stage graph, run by the generic executor; lap-placement and flux-placement (full, block or
+        // inline) select the placement of lap and of flx and fly, so all nine combinations of fusion and temporary
+        // storage are available with the same stage definitions
+        template <class Platform, class ValueType>
+        class x86_hdiff_variant_stage_graph final : public x86_hdiff_stencil_variant<Platform, ValueType> {
+          public:
+            using value_type = ValueType;
+
+            struct graph {
+                struct in {};
+                struct coeff {};
+
+                struct lap {
+                    using reads = stage_graph::list<stage_graph::read<in, -1, 1, -1, 1>>;
+
+                    template <class Env>
+                    static value_type apply(const Env &e, const int i, const int j) {
+                        return 4 * e.template get<in>(i, j) -
+                               (e.template get<in>(i - 1, j) + e.template get<in>(i + 1, j) +
+                                   e.template get<in>(i, j - 1) + e.template get<in>(i, j + 1));
+                    }
+                };
+
+                struct flx {
+                    using reads =
+                        stage_graph::list<stage_graph::read<in, 0, 1, 0, 0>, stage_graph::read<lap, 0, 1, 0, 0>>;
+
+                    template <class Env>
+                    static value_type apply(const Env &e, const int i, const int j) {
+                        const value_type f = e.template get<lap>(i + 1, j) - e.template get<lap>(i, j);
+                        return f * (e.template get<in>(i + 1, j) - e.template get<in>(i, j)) > 0 ? value_type(0) : f;
+                    }
+                };
+
+                struct fly {
+                    using reads =
+                        stage_graph::list<stage_graph::read<in, 0, 0, 0, 1>, stage_graph::read<lap, 0, 0, 0, 1>>;
+
+                    template <class Env>
+                    static value_type apply(const Env &e, const int i, const int j) {
+                        const value_type f = e.template get<lap>(i, j + 1) - e.template get<lap>(i, j);
+                        return f * (e.template get<in>(i, j + 1) - e.template get<in>(i, j)) > 0 ? value_type(0) : f;
+                    }
+                };
+
+                struct out {
+                    using reads = stage_graph::list<stage_graph::read<in, 0, 0, 0, 0>,
+                        stage_graph::read<coeff, 0, 0, 0, 0>,
+                        stage_graph::read<flx, -1, 0, 0, 0>,
+                        stage_graph::read<fly, 0, 0, -1, 0>>;
+
+                    template <class Env>
+                    static value_type apply(const Env &e, const int i, const int j) {
+                        return e.template get<in>(i, j) -
+                               e.template get<coeff>(i, j) *
+                                   (e.template get<flx>(i, j) - e.template get<flx>(i - 1, j) +
+                                       e.template get<fly>(i, j) - e.template get<fly>(i, j - 1));
+                    }
+                };
+
+                using sources = stage_graph::list<in, coeff>;
+                using stages = stage_graph::list<lap, flx, fly, out>;
+            };
+
+            x86_hdiff_variant_stage_graph(const arguments_map &args)
+                : x86_hdiff_stencil_variant<Platform, ValueType>(
+                      args, args.get("lap-placement") == "full" || args.get("flux-placement") == "full") {
+                m_domain.isize = this->isize();
+                m_domain.jsize = this->jsize();
+                m_domain.ksize = this->ksize();
+                m_domain.jstride = this->jstride();
+                m_domain.kstride = this->kstride();
+                m_domain.iblocksize = args.get<int>("i-blocksize");
+                m_domain.jblocksize = args.get<int>("j-blocksize");
+                if (m_domain.iblocksize <= 0 || m_domain.jblocksize <= 0)
+                    throw ERROR("invalid block size");
+                if (this->istride() != 1)
+                    throw ERROR("this variant is only compatible with unit i-stride layout");
+                if (this->halo() < 2)
+                    throw ERROR("Minimum required halo is 2");
+
+                const std::string lap = args.get("lap-placement");
+                if (lap == "full")
+                    m_run = select_flux<stage_graph::full>(args.get("flux-placement"));
+                else if (lap == "block")
+                    m_run = select_flux<stage_graph::block>(args.get("flux-placement"));
+                else if (lap == "inline")
+                    m_run = select_flux<stage_graph::on_the_fly>(args.get("flux-placement"));
+                else
+                    throw ERROR("invalid lap-placement '" + lap + "'");
+                m_full_fields = (lap == "full" ? 1 : 0) + (args.get("flux-placement") == "full" ? 2 : 0);
+            }
+
+            void hdiff() override {
+                // the full fields are only allocated if one of the stages is placed in a full field, the
+                // executor ignores the pointers of the other stages
+                const bool full = m_full;
+                m_run(m_domain,
+                    {{this->in(),
+                        this->coeff(),
+                        full ? this->lap() : nullptr,
+                        full ? this->flx() : nullptr,
+                        full ? this->fly() : nullptr,
+                        this->out()}});
+            }
+
+          protected:
+            // in, coeff and out, plus lap, flx and fly where they are placed in full fields; block and inline
+            // placements never leave the cache
+            std::size_t touched_elements(const std::string &stencil) const override {
+                if (stencil != "hdiff")
+                    throw ERROR("unknown stencil '" + stencil + "'");
+                const std::size_t i = this->isize(), j = this->jsize(), k = this->ksize();
+                return i * j * k * (3 + m_full_fields) * this->timesteps();
+            }
+
+          private:
+            using field_pointers = std::array<value_type *, 6>;
+            using run_function = void (*)(const stage_graph::domain &, const field_pointers &);
+
+            template <class LapPlacement, class FluxPlacement>
+            using config = stage_graph::list<stage_graph::place<typename graph::lap, LapPlacement>,
+                stage_graph::place<typename graph::flx, FluxPlacement>,
+                stage_graph::place<typename graph::fly, FluxPlacement>>;
+
+            template <class LapPlacement>
+            run_function select_flux(const std::string &flux) {
+                m_full = std::is_same<LapPlacement, stage_graph::full>::value || flux == "full";
+                if (flux == "full")
+                    return &stage_graph::executor<graph, config<LapPlacement, stage_graph::full>, value_type>::run;
+                if (flux == "block")
+                    return &stage_graph::executor<graph, config<LapPlacement, stage_graph::block>, value_type>::run;
+                if (flux == "inline")
+                    return &stage_graph::executor<graph, config<LapPlacement, stage_graph::on_the_fly>,
+                        value_type>::run;
+                throw ERROR("invalid flux-placement '" + flux + "'");
+            }
+
+            stage_graph::domain m_domain;
+            run_function m_run;
+            bool m_full;
+            int m_full_fields;
+        };
+
+    } // namespace x86
+
+} // namespace platform
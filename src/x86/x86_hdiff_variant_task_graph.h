@@ -0,0 +1,277 @@
+#pragma once
+
+#include <algorithm>
+#include <omp.h>
+#include <sstream>
+#include <vector>
+
+#include "x86/x86_hdiff_stencil_variant.h"
+
+namespace platform {
+
+    namespace x86 {
+
+        // non-redundant hdiff on (i-blocksize x j-blocksize x k-blocksize) blocks as an OpenMP task graph: the
+        // lap, flux and out tasks of a block depend only on the tasks of the same k-block they read from, so a
+        // block starts its flux stage as soon as lap of its i- and j-successor is done; stencil hdiff-barrier runs
+        // the same blocks with barriers between the stages for comparison; the average idle fraction of the
+        // threads over the timed runs of both is reported in the notes of the results
+        template <class Platform, class ValueType>
+        class x86_hdiff_variant_task_graph final : public x86_hdiff_stencil_variant<Platform, ValueType> {
+          public:
+            using value_type = ValueType;
+
+            x86_hdiff_variant_task_graph(const arguments_map &args)
+                : x86_hdiff_stencil_variant<Platform, ValueType>(args), m_iblocksize(args.get<int>("i-blocksize")),
+                  m_jblocksize(args.get<int>("j-blocksize")), m_kblocksize(args.get<int>("k-blocksize")),
+                  m_barrier(false) {
+                if (m_iblocksize <= 0 || m_jblocksize <= 0 || m_kblocksize <= 0)
+                    throw ERROR("invalid block size");
+                if (this->istride() != 1)
+                    throw ERROR("this variant is only compatible with unit i-stride layout");
+                if (this->halo() < 2)
+                    throw ERROR("Minimum required halo is 2");
+                m_iblocks = (this->isize() + m_iblocksize - 1) / m_iblocksize;
+                m_jblocks = (this->jsize() + m_jblocksize - 1) / m_jblocksize;
+                m_kblocks = (this->ksize() + m_kblocksize - 1) / m_kblocksize;
+                m_lap_deps.resize(m_iblocks * m_jblocks * m_kblocks);
+                m_flux_deps.resize(m_iblocks * m_jblocks * m_kblocks);
+            }
+
+            std::vector<std::string> stencil_list() const override { return {"hdiff", "hdiff-barrier"}; }
+
+            void hdiff() override {
+                const int iblocks = m_iblocks;
+                const int blocks = m_iblocks * m_jblocks;
+                const int kblocks = m_kblocks;
+                char *lap_deps = m_lap_deps.data();
+                char *flux_deps = m_flux_deps.data();
+                double busy = 0;
+
+                const double start = omp_get_wtime();
+                int threads = 1;
+                if (m_barrier) {
+#pragma omp parallel reduction(+ : busy)
+                    {
+#pragma omp single
+                        threads = omp_get_num_threads();
+                        for (int c = 0; c < kblocks; ++c) {
+#pragma omp for schedule(static)
+                            for (int b = 0; b < blocks; ++b)
+                                busy += timed([&]() { laplacian(b, c); });
+#pragma omp for schedule(static)
+                            for (int b = 0; b < blocks; ++b)
+                                busy += timed([&]() { fluxes(b, c); });
+#pragma omp for schedule(static)
+                            for (int b = 0; b < blocks; ++b)
+                                busy += timed([&]() { update(b, c); });
+                        }
+                    }
+                } else {
+                    std::vector<double> thread_busy(omp_get_max_threads(), 0.0);
+#pragma omp parallel
+                    {
+#pragma omp single
+                        {
+                            threads = omp_get_num_threads();
+                            for (int c = 0; c < kblocks; ++c) {
+                                char *lap_dep = lap_deps + c * blocks;
+                                char *flux_dep = flux_deps + c * blocks;
+                                for (int b = 0; b < blocks; ++b) {
+#pragma omp task depend(out : lap_dep[b]) shared(thread_busy)
+                                    thread_busy[omp_get_thread_num()] += timed([&]() { laplacian(b, c); });
+                                }
+                                for (int b = 0; b < blocks; ++b) {
+                                    // missing neighbours at the domain boundary are replaced by the block itself
+                                    const int right = b % iblocks + 1 < iblocks ? b + 1 : b;
+                                    const int up = b + iblocks < blocks ? b + iblocks : b;
+#pragma omp task depend(in : lap_dep[b], lap_dep[right], lap_dep[up]) depend(out : flux_dep[b]) \
+    shared(thread_busy)
+                                    thread_busy[omp_get_thread_num()] += timed([&]() { fluxes(b, c); });
+                                }
+                                for (int b = 0; b < blocks; ++b) {
+                                    const int left = b % iblocks > 0 ? b - 1 : b;
+                                    const int down = b >= iblocks ? b - iblocks : b;
+#pragma omp task depend(in : flux_dep[b], flux_dep[left], flux_dep[down]) shared(thread_busy)
+                                    thread_busy[omp_get_thread_num()] += timed([&]() { update(b, c); });
+                                }
+                            }
+                        }
+                    }
+                    for (double t : thread_busy)
+                        busy += t;
+                }
+                const double wall = omp_get_wtime() - start;
+
+                idle_stats &s = m_stats[m_barrier ? 1 : 0];
+                if (this->timed_run() && wall > 0) {
+                    s.idle += std::max(0.0, 1.0 - busy / (threads * wall));
+                    ++s.calls;
+                }
+            }
+
+          protected:
+            std::function<void()> stencil_function(const std::string &stencil) override {
+                if (stencil == "hdiff-barrier") {
+                    return [this]() {
+                        m_barrier = true;
+                        this->hdiff_timesteps();
+                        m_barrier = false;
+                    };
+                }
+                return x86_hdiff_stencil_variant<Platform, ValueType>::stencil_function(stencil);
+            }
+
+            bool verify(const std::string &stencil) override {
+                return x86_hdiff_stencil_variant<Platform, ValueType>::verify(
+                    stencil == "hdiff-barrier" ? "hdiff" : stencil);
+            }
+
+            std::size_t touched_elements(const std::string &stencil) const override {
+                return x86_hdiff_stencil_variant<Platform, ValueType>::touched_elements(
+                    stencil == "hdiff-barrier" ? "hdiff" : stencil);
+            }
+
+            std::vector<std::string> notes(const std::string &stencil) const override {
+                const int barrier = stencil == "hdiff-barrier" ? 1 : 0;
+                const idle_stats &s = m_stats[barrier];
+                std::vector<std::string> notes;
+                if (s.calls == 0)
+                    return notes;
+                std::stringstream note;
+                note << stencil << ": avg. idle fraction of threads " << s.idle / s.calls << " (" << s.calls
+                     << " timed calls)";
+                notes.push_back(note.str());
+                // hdiff-barrier runs after hdiff with stencil all, so both are known here
+                if (barrier && m_stats[0].calls > 0) {
+                    std::stringstream removed;
+                    removed << "idle fraction removed by the task graph: "
+                            << m_stats[1].idle / m_stats[1].calls - m_stats[0].idle / m_stats[0].calls;
+                    notes.push_back(removed.str());
+                }
+                return notes;
+            }
+
+          private:
+            struct idle_stats {
+                double idle = 0;
+                int calls = 0;
+            };
+
+            template <class F>
+            static double timed(F f) {
+                const double start = omp_get_wtime();
+                f();
+                return omp_get_wtime() - start;
+            }
+
+            // ij-block b of k-block c covers [ib, imax) x [jb, jmax) x [kb, kmax), blocks at the domain boundary
+            // also own the boundary lines of lap, flx and fly outside the domain
+            void block_range(
+                const int b, const int c, int &ib, int &imax, int &jb, int &jmax, int &kb, int &kmax) const {
+                ib = b % m_iblocks * m_iblocksize;
+                jb = b / m_iblocks * m_jblocksize;
+                kb = c * m_kblocksize;
+                imax = std::min(ib + m_iblocksize, this->isize());
+                jmax = std::min(jb + m_jblocksize, this->jsize());
+                kmax = std::min(kb + m_kblocksize, this->ksize());
+            }
+
+            void laplacian(const int b, const int c) {
+                const value_type *__restrict__ in = this->in();
+                value_type *__restrict__ lap = this->lap();
+                constexpr int istride = 1;
+                const int jstride = this->jstride();
+                const int kstride = this->kstride();
+                int ib, imax, jb, jmax, kb, kmax;
+                block_range(b, c, ib, imax, jb, jmax, kb, kmax);
+                const int ilo = ib == 0 ? -1 : ib, ihi = imax == this->isize() ? imax + 1 : imax;
+                const int jlo = jb == 0 ? -1 : jb, jhi = jmax == this->jsize() ? jmax + 1 : jmax;
+
+                for (int k = kb; k < kmax; ++k) {
+                    for (int j = jlo; j < jhi; ++j) {
+                        const int row = j * jstride + k * kstride;
+#pragma omp simd
+                        for (int i = ilo; i < ihi; ++i) {
+                            const int index = row + i * istride;
+                            lap[index] = 4 * in[index] - (in[index - istride] + in[index + istride] +
+                                                             in[index - jstride] + in[index + jstride]);
+                        }
+                    }
+                }
+            }
+
+            void fluxes(const int b, const int c) {
+                const value_type *__restrict__ in = this->in();
+                const value_type *__restrict__ lap = this->lap();
+                value_type *__restrict__ flx = this->flx();
+                value_type *__restrict__ fly = this->fly();
+                constexpr int istride = 1;
+                const int jstride = this->jstride();
+                const int kstride = this->kstride();
+                int ib, imax, jb, jmax, kb, kmax;
+                block_range(b, c, ib, imax, jb, jmax, kb, kmax);
+                const int ilo = ib == 0 ? -1 : ib;
+                const int jlo = jb == 0 ? -1 : jb;
+
+                for (int k = kb; k < kmax; ++k) {
+                    for (int j = jb; j < jmax; ++j) {
+                        const int row = j * jstride + k * kstride;
+#pragma omp simd
+                        for (int i = ilo; i < imax; ++i) {
+                            const int index = row + i * istride;
+                            flx[index] = lap[index + istride] - lap[index];
+                            if (flx[index] * (in[index + istride] - in[index]) > 0)
+                                flx[index] = 0.;
+                        }
+                    }
+
+                    for (int j = jlo; j < jmax; ++j) {
+                        const int row = j * jstride + k * kstride;
+#pragma omp simd
+                        for (int i = ib; i < imax; ++i) {
+                            const int index = row + i * istride;
+                            fly[index] = lap[index + jstride] - lap[index];
+                            if (fly[index] * (in[index + jstride] - in[index]) > 0)
+                                fly[index] = 0.;
+                        }
+                    }
+                }
+            }
+
+            void update(const int b, const int c) {
+                const value_type *__restrict__ in = this->in();
+                const value_type *__restrict__ coeff = this->coeff();
+                const value_type *__restrict__ flx = this->flx();
+                const value_type *__restrict__ fly = this->fly();
+                value_type *__restrict__ out = this->out();
+                constexpr int istride = 1;
+                const int jstride = this->jstride();
+                const int kstride = this->kstride();
+                int ib, imax, jb, jmax, kb, kmax;
+                block_range(b, c, ib, imax, jb, jmax, kb, kmax);
+
+                for (int k = kb; k < kmax; ++k) {
+                    for (int j = jb; j < jmax; ++j) {
+                        const int row = j * jstride + k * kstride;
+#pragma omp simd
+                        for (int i = ib; i < imax; ++i) {
+                            const int index = row + i * istride;
+                            out[index] = in[index] - coeff[index] * (flx[index] - flx[index - istride] + fly[index] -
+                                                                        fly[index - jstride]);
+                        }
+                    }
+                }
+            }
+
+            int m_iblocksize, m_jblocksize, m_kblocksize;
+            int m_iblocks, m_jblocks, m_kblocks;
+            // dependency sentinels of the lap and flux tasks, one element per ij-block and k-block
+            std::vector<char> m_lap_deps, m_flux_deps;
+            bool m_barrier;
+            idle_stats m_stats[2];
+        };
+
+    } // namespace x86
+
+} // namespace platform
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "x86/x86_hdiff_stencil_variant.h"
+
+namespace platform {
+
+    namespace x86 {
+
+        // advances up to t-blocksize time steps per ij-tile and k-level while the tile stays in cache: overlapped
+        // tiles, the region computed in step t of a block of T steps is the tile grown by 2 * (T - t) points, so
+        // the last step only needs data computed by the same thread; the intermediate steps go to two per-thread
+        // ping-pong buffers, only the tile of the last step is written back
+        template <class Platform, class ValueType>
+        class x86_hdiff_variant_temporal_blocked final : public x86_hdiff_stencil_variant<Platform, ValueType> {
+          public:
+            using value_type = ValueType;
+
+            x86_hdiff_variant_temporal_blocked(const arguments_map &args)
+                : x86_hdiff_stencil_variant<Platform, ValueType>(args, false),
+                  m_iblocksize(args.get<int>("i-blocksize")), m_jblocksize(args.get<int>("j-blocksize")),
+                  m_tblocksize(args.get<int>("t-blocksize")) {
+                if (m_iblocksize <= 0 || m_jblocksize <= 0 || m_tblocksize <= 0)
+                    throw ERROR("invalid block size");
+                if (this->istride() != 1)
+                    throw ERROR("this variant is only compatible with unit i-stride layout");
+                if (this->halo() < 2)
+                    throw ERROR("Minimum required halo is 2");
+            }
+
+            void hdiff() override { advance(this->in(), this->out(), 1); }
+
+            void hdiff_timesteps() override {
+                const int timesteps = this->timesteps();
+                const int blocks = (timesteps + m_tblocksize - 1) / m_tblocksize;
+                const value_type *src = this->in();
+                for (int b = 0; b < blocks; ++b) {
+                    const int steps = std::min(m_tblocksize, timesteps - b * m_tblocksize);
+                    // the destination alternates such that the last block writes to out
+                    value_type *dst = (blocks - 1 - b) % 2 == 0 ? this->out() : this->tmp();
+                    advance(src, dst, steps);
+                    src = dst;
+                }
+            }
+
+          private:
+            // the tile buffers cover the tile grown by 2 * steps, their element (i, j) is at
+            // (i - ib + 2 * steps) + (j - jb + 2 * steps) * width
+            struct tile_buffers {
+                int width;
+                std::vector<value_type> buf[2], rows;
+            };
+
+            void advance(const value_type *src, value_type *dst, const int steps) {
+                const int isize = this->isize();
+                const int jsize = this->jsize();
+                const int ksize = this->ksize();
+
+#pragma omp parallel
+                {
+                    tile_buffers tb;
+                    tb.width = m_iblocksize + 4 * steps;
+                    const int size = tb.width * (m_jblocksize + 4 * steps);
+                    tb.buf[0].resize(size);
+                    tb.buf[1].resize(size);
+                    // row window of step(), rows need one more point on each side than the computed region
+                    tb.rows.resize(6 * (tb.width + 2));
+
+#pragma omp for collapse(3) schedule(static)
+                    for (int k = 0; k < ksize; ++k) {
+                        for (int jb = 0; jb < jsize; jb += m_jblocksize) {
+                            for (int ib = 0; ib < isize; ib += m_iblocksize) {
+                                const int imax = std::min(ib + m_iblocksize, isize);
+                                const int jmax = std::min(jb + m_jblocksize, jsize);
+                                advance_tile(src, dst, steps, ib, imax, jb, jmax, k, tb);
+                            }
+                        }
+                    }
+                }
+            }
+
+            void advance_tile(const value_type *src,
+                value_type *dst,
+                const int steps,
+                const int ib,
+                const int imax,
+                const int jb,
+                const int jmax,
+                const int k,
+                tile_buffers &tb) {
+                const int isize = this->isize();
+                const int jsize = this->jsize();
+                const int jstride = this->jstride();
+                const int kstride = this->kstride();
+                const int width = tb.width;
+                const int i0 = ib - 2 * steps;
+                const int j0 = jb - 2 * steps;
+                const value_type *coeff = this->coeff() + k * kstride;
+                src += k * kstride;
+                dst += k * kstride;
+
+                // the halo is never updated, later steps read it from the tile buffers
+                if (steps > 1) {
+                    const int ilo = std::max(i0, -2), ihi = std::min(imax + 2 * steps, isize + 2);
+                    const int jlo = std::max(j0, -2), jhi = std::min(jmax + 2 * steps, jsize + 2);
+                    for (int j = jlo; j < jhi; ++j) {
+                        for (int i = ilo; i < ihi; ++i) {
+                            if (i < 0 || i >= isize || j < 0 || j >= jsize) {
+                                const int l = (i - i0) + (j - j0) * width;
+                                tb.buf[0][l] = tb.buf[1][l] = src[i + j * jstride];
+                            }
+                        }
+                    }
+                }
+
+                for (int t = 1; t <= steps; ++t) {
+                    // region of this step, grown tile clipped to the domain
+                    const int g = 2 * (steps - t);
+                    const int rimin = std::max(ib - g, 0), rimax = std::min(imax + g, isize);
+                    const int rjmin = std::max(jb - g, 0), rjmax = std::min(jmax + g, jsize);
+                    const int roffset = (rimin - i0) + (rjmin - j0) * width;
+
+                    const value_type *in;
+                    int in_jstride;
+                    if (t == 1) {
+                        in = src + rimin + rjmin * jstride;
+                        in_jstride = jstride;
+                    } else {
+                        in = tb.buf[t % 2].data() + roffset;
+                        in_jstride = width;
+                    }
+                    value_type *out;
+                    int out_jstride;
+                    if (t == steps) {
+                        out = dst + rimin + rjmin * jstride;
+                        out_jstride = jstride;
+                    } else {
+                        out = tb.buf[(t + 1) % 2].data() + roffset;
+                        out_jstride = width;
+                    }
+                    step(in,
+                        in_jstride,
+                        coeff + rimin + rjmin * jstride,
+                        jstride,
+                        out,
+                        out_jstride,
+                        rimax - rimin,
+                        rjmax - rjmin,
+                        tb);
+                }
+            }
+
+            // lap of row j for i in [-1, n + 1), element i is at i + 1
+            static void laplacian(value_type *__restrict__ lap,
+                const value_type *__restrict__ in,
+                const int jstride,
+                const int n,
+                const int j) {
+                constexpr int istride = 1;
+#pragma omp simd
+                for (int i = -1; i < n + 1; ++i) {
+                    const int index = i * istride + j * jstride;
+                    lap[i + 1] = 4 * in[index] -
+                                 (in[index - istride] + in[index + istride] + in[index - jstride] + in[index + jstride]);
+                }
+            }
+
+            // one hdiff step on an n x m region, all pointers point to element (0, 0) of the region; single sweep
+            // over j with a rolling window of three lap rows, two fly rows and one flx row, element i of a row is
+            // at i + 1
+            void step(const value_type *__restrict__ in,
+                const int jstride,
+                const value_type *__restrict__ coeff,
+                const int coeff_jstride,
+                value_type *__restrict__ out,
+                const int out_jstride,
+                const int n,
+                const int m,
+                tile_buffers &tb) {
+                constexpr int istride = 1;
+                const int rowsize = tb.width + 2;
+                value_type *rows = tb.rows.data();
+                // lap of row j is kept in slot (j + 1) % 3, fly of row j in slot (j + 1) % 2
+                auto lap_row = [&](int j) { return rows + (j + 1) % 3 * rowsize; };
+                auto fly_row = [&](int j) { return rows + (3 + (j + 1) % 2) * rowsize; };
+                value_type *__restrict__ flx = rows + 5 * rowsize;
+
+                laplacian(lap_row(-1), in, jstride, n, -1);
+                laplacian(lap_row(0), in, jstride, n, 0);
+
+                for (int j = -1; j < m; ++j) {
+                    const value_type *__restrict__ lapc = lap_row(j);
+                    const value_type *__restrict__ lapp = lap_row(j + 1);
+                    value_type *__restrict__ flyc = fly_row(j);
+                    if (j + 1 < m)
+                        laplacian(lap_row(j + 2), in, jstride, n, j + 2);
+#pragma omp simd
+                    for (int i = 0; i < n; ++i) {
+                        const int index = i * istride + j * jstride;
+                        flyc[i + 1] = lapp[i + 1] - lapc[i + 1];
+                        if (flyc[i + 1] * (in[index + jstride] - in[index]) > 0)
+                            flyc[i + 1] = 0.;
+                    }
+                    if (j < 0)
+                        continue;
+
+                    const value_type *__restrict__ flym = fly_row(j - 1);
+#pragma omp simd
+                    for (int i = -1; i < n; ++i) {
+                        const int index = i * istride + j * jstride;
+                        flx[i + 1] = lapc[i + 2] - lapc[i + 1];
+                        if (flx[i + 1] * (in[index + istride] - in[index]) > 0)
+                            flx[i + 1] = 0.;
+                    }
+
+#pragma omp simd
+                    for (int i = 0; i < n; ++i) {
+                        out[i + j * out_jstride] =
+                            in[i + j * jstride] -
+                            coeff[i + j * coeff_jstride] * (flx[i + 1] - flx[i] + flyc[i + 1] - flym[i + 1]);
+                    }
+                }
+            }
+
+            int m_iblocksize, m_jblocksize, m_tblocksize;
+        };
+
+    } // namespace x86
+
+} // namespace platform
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "x86/x86_hdiff_stencil_variant.h"
+
+namespace platform {
+
+    namespace x86 {
+
+        // two levels of ij-blocking: every thread computes lap for a whole L2-sized tile (i-blocksize x
+        // j-blocksize) at once, so only the tile borders are computed redundantly; flx, fly and out are then
+        // computed per L1-sized sub-tile (i-subblocksize x j-subblocksize), the flx and fly buffers of a sub-tile
+        // stay in L1 while lap is read from the tile buffer in L2
+        template <class Platform, class ValueType>
+        class x86_hdiff_variant_two_level_blocked final : public x86_hdiff_stencil_variant<Platform, ValueType> {
+          public:
+            using value_type = ValueType;
+            using allocator = typename x86_hdiff_stencil_variant<Platform, ValueType>::allocator;
+
+            x86_hdiff_variant_two_level_blocked(const arguments_map &args)
+                : x86_hdiff_stencil_variant<Platform, ValueType>(args, false),
+                  m_iblocksize(args.get<int>("i-blocksize")), m_jblocksize(args.get<int>("j-blocksize")),
+                  m_isubblocksize(args.get<int>("i-subblocksize")), m_jsubblocksize(args.get<int>("j-subblocksize")) {
+                if (m_iblocksize <= 0 || m_jblocksize <= 0 || m_isubblocksize <= 0 || m_jsubblocksize <= 0)
+                    throw ERROR("invalid block size");
+                if (this->istride() != 1)
+                    throw ERROR("this variant is only compatible with unit i-stride layout");
+                if (this->halo() < 2)
+                    throw ERROR("Minimum required halo is 2");
+                // sub-tiles never exceed the tile
+                m_isubblocksize = std::min(m_isubblocksize, m_iblocksize);
+                m_jsubblocksize = std::min(m_jsubblocksize, m_jblocksize);
+                // lap tile strides, rows padded to the alignment
+                m_jstride_lap = (m_iblocksize + 2 + this->alignment() - 1) / this->alignment() * this->alignment();
+            }
+
+            void hdiff() override {
+                const int isize = this->isize();
+                const int jsize = this->jsize();
+                const int ksize = this->ksize();
+
+#pragma omp parallel
+                {
+                    buffers buf;
+                    buf.lap.resize(m_jstride_lap * (m_jblocksize + 2));
+                    buf.flx.resize((m_isubblocksize + 1) * m_jsubblocksize);
+                    buf.fly.resize(m_isubblocksize * (m_jsubblocksize + 1));
+
+#pragma omp for collapse(3) schedule(static)
+                    for (int k = 0; k < ksize; ++k) {
+                        for (int jb = 0; jb < jsize; jb += m_jblocksize) {
+                            for (int ib = 0; ib < isize; ib += m_iblocksize) {
+                                const int imax = std::min(ib + m_iblocksize, isize);
+                                const int jmax = std::min(jb + m_jblocksize, jsize);
+                                tile(ib, imax, jb, jmax, k, buf);
+                            }
+                        }
+                    }
+                }
+            }
+
+          protected:
+            // lap lives in the per-thread tile buffer, flx and fly in the sub-tile buffers, so only in, coeff and out
+            // go to memory
+            std::size_t touched_elements(const std::string &stencil) const override {
+                if (stencil != "hdiff")
+                    throw ERROR("unknown stencil '" + stencil + "'");
+                const std::size_t i = this->isize(), j = this->jsize(), k = this->ksize();
+                return i * j * k * 3 * this->timesteps();
+            }
+
+          private:
+            struct buffers {
+                std::vector<value_type, allocator> lap, flx, fly;
+            };
+
+            void tile(const int ib, const int imax, const int jb, const int jmax, const int k, buffers &buf) {
+                const value_type *__restrict__ in = this->in();
+                const value_type *__restrict__ coeff = this->coeff();
+                value_type *__restrict__ out = this->out();
+
+                constexpr int istride = 1;
+                const int jstride = this->jstride();
+                const int kstride = this->kstride();
+                const int jstride_lap = m_jstride_lap;
+                const int n = imax - ib;
+                const int m = jmax - jb;
+                const int index = ib * istride + jb * jstride + k * kstride;
+
+                // element (i, j) of the tile is at (i + 1) + (j + 1) * jstride_lap
+                value_type *__restrict__ lap = buf.lap.data() + 1 + jstride_lap;
+                for (int j = -1; j < m + 1; ++j) {
+#pragma omp simd
+                    for (int i = -1; i < n + 1; ++i) {
+                        const int c = index + i * istride + j * jstride;
+                        lap[i + j * jstride_lap] =
+                            4 * in[c] - (in[c - istride] + in[c + istride] + in[c - jstride] + in[c + jstride]);
+                    }
+                }
+
+                for (int jsb = 0; jsb < m; jsb += m_jsubblocksize) {
+                    for (int isb = 0; isb < n; isb += m_isubblocksize) {
+                        const int sn = std::min(m_isubblocksize, n - isb);
+                        const int sm = std::min(m_jsubblocksize, m - jsb);
+                        sub_tile(in + index + isb * istride + jsb * jstride,
+                            coeff + index + isb * istride + jsb * jstride,
+                            out + index + isb * istride + jsb * jstride,
+                            lap + isb + jsb * jstride_lap,
+                            sn,
+                            sm,
+                            buf);
+                    }
+                }
+            }
+
+            // flx, fly and out of an n x m sub-tile, all pointers point to element (0, 0) of the sub-tile
+            void sub_tile(const value_type *__restrict__ in,
+                const value_type *__restrict__ coeff,
+                value_type *__restrict__ out,
+                const value_type *__restrict__ lap,
+                const int n,
+                const int m,
+                buffers &buf) {
+                constexpr int istride = 1;
+                const int jstride = this->jstride();
+                const int jstride_lap = m_jstride_lap;
+                // flx (i, j) is at (i + 1) + j * jstride_flx, fly (i, j) at i + (j + 1) * jstride_fly
+                const int jstride_flx = m_isubblocksize + 1;
+                const int jstride_fly = m_isubblocksize;
+                value_type *__restrict__ flx = buf.flx.data() + 1;
+                value_type *__restrict__ fly = buf.fly.data() + jstride_fly;
+
+                for (int j = 0; j < m; ++j) {
+#pragma omp simd
+                    for (int i = -1; i < n; ++i) {
+                        const int c = i * istride + j * jstride;
+                        const int l = i + j * jstride_lap;
+                        const int f = i + j * jstride_flx;
+                        flx[f] = lap[l + 1] - lap[l];
+                        if (flx[f] * (in[c + istride] - in[c]) > 0)
+                            flx[f] = 0.;
+                    }
+                }
+
+                for (int j = -1; j < m; ++j) {
+#pragma omp simd
+                    for (int i = 0; i < n; ++i) {
+                        const int c = i * istride + j * jstride;
+                        const int l = i + j * jstride_lap;
+                        const int f = i + j * jstride_fly;
+                        fly[f] = lap[l + jstride_lap] - lap[l];
+                        if (fly[f] * (in[c + jstride] - in[c]) > 0)
+                            fly[f] = 0.;
+                    }
+                }
+
+                for (int j = 0; j < m; ++j) {
+#pragma omp simd
+                    for (int i = 0; i < n; ++i) {
+                        const int c = i * istride + j * jstride;
+                        const int fx = i + j * jstride_flx;
+                        const int fy = i + j * jstride_fly;
+                        out[c] = in[c] - coeff[c] * (flx[fx] - flx[fx - 1] + fly[fy] - fly[fy - jstride_fly]);
+                    }
+                }
+            }
+
+            int m_iblocksize, m_jblocksize, m_isubblocksize, m_jsubblocksize;
+            int m_jstride_lap;
+        };
+
+    } // namespace x86
+
+} // namespace platform
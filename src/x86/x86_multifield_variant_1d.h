@@ -0,0 +1,74 @@
+#pragma once
+
+#include "multifield_kernel.h"
+#include "x86/x86_basic_multifield_variant.h"
+
+namespace platform {
+
+    namespace x86 {
+
+        template <class Platform, class ValueType>
+        class multifield_variant_1d final : public x86_basic_multifield_variant<Platform, ValueType> {
+          public:
+            using value_type = ValueType;
+
+            multifield_variant_1d(const arguments_map &args)
+                : x86_basic_multifield_variant<Platform, ValueType>(args, parse_field_layout(args.get("layout"))) {}
+
+            void copy() override { run_stencil<multifield::copy>(); }
+            void copyi() override { run_stencil<multifield::copyi>(); }
+            void copyj() override { run_stencil<multifield::copyj>(); }
+            void copyk() override { run_stencil<multifield::copyk>(); }
+            void avgi() override { run_stencil<multifield::avgi>(); }
+            void avgj() override { run_stencil<multifield::avgj>(); }
+            void avgk() override { run_stencil<multifield::avgk>(); }
+            void sumi() override { run_stencil<multifield::sumi>(); }
+            void sumj() override { run_stencil<multifield::sumj>(); }
+            void sumk() override { run_stencil<multifield::sumk>(); }
+            void lapij() override { run_stencil<multifield::lapij>(); }
+
+          private:
+            // one pass over Fields fields on the index range [begin, end)
+            template <class Stencil>
+            struct pass {
+                Stencil stencil;
+                value_type *dst;
+                int begin, end;
+
+                template <int Fields, class Layout>
+                void run(const Layout &src, bool accumulate, bool) const {
+                    multifield::apply<Fields>(src, stencil, dst, begin, end, accumulate);
+                }
+            };
+
+            template <class Stencil>
+            void run_stencil() {
+                if (this->layout() == field_layout::soa)
+                    run_stencil<Stencil>(this->soa_fields());
+                else if (this->layout() == field_layout::aos)
+                    run_stencil<Stencil>(this->aos_fields());
+                else
+                    run_stencil<Stencil>(this->aosoa_fields());
+            }
+
+            // the index range is split into chunks, so dst stays in cache when passing multiple times over it
+            template <class Stencil, class Layout>
+            void run_stencil(const Layout &src) {
+                constexpr int chunk = 4096;
+                const int last = this->index(this->isize() - 1, this->jsize() - 1, this->ksize() - 1);
+                const Stencil stencil{this->istride(), this->jstride(), this->kstride()};
+                const int fields = this->fields();
+                const int per_pass = this->fields_per_pass();
+                value_type *dst = this->dst();
+
+#pragma omp parallel for schedule(static)
+                for (int begin = 0; begin <= last; begin += chunk) {
+                    const pass<Stencil> p{stencil, dst, begin, std::min(begin + chunk, last + 1)};
+                    multifield::run_passes(p, src, fields, per_pass);
+                }
+            }
+        };
+
+    } // namespace x86
+
+} // namespace platform
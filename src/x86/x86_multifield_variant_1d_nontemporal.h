@@ -0,0 +1,88 @@
+#pragma once
+
+#include "multifield_kernel.h"
+#include "x86/x86_basic_multifield_variant.h"
+#include "x86/x86_nontemporal.h"
+
+namespace platform {
+
+    namespace x86 {
+
+        template <class Platform, class ValueType>
+        class multifield_variant_1d_nontemporal final : public x86_basic_multifield_variant<Platform, ValueType> {
+          public:
+            using value_type = ValueType;
+
+            multifield_variant_1d_nontemporal(const arguments_map &args)
+                : x86_basic_multifield_variant<Platform, ValueType>(args),
+                  m_policy(parse_store_policy(args.get("store"),
+                      (this->fields() + 1) * this->storage_size() * sizeof(value_type),
+                      Platform::llc_size())) {}
+
+            void copy() override { run_stencil<multifield::copy>(); }
+            void copyi() override { run_stencil<multifield::copyi>(); }
+            void copyj() override { run_stencil<multifield::copyj>(); }
+            void copyk() override { run_stencil<multifield::copyk>(); }
+            void avgi() override { run_stencil<multifield::avgi>(); }
+            void avgj() override { run_stencil<multifield::avgj>(); }
+            void avgk() override { run_stencil<multifield::avgk>(); }
+            void sumi() override { run_stencil<multifield::sumi>(); }
+            void sumj() override { run_stencil<multifield::sumj>(); }
+            void sumk() override { run_stencil<multifield::sumk>(); }
+            void lapij() override { run_stencil<multifield::lapij>(); }
+
+          private:
+            // one pass over Fields fields on the index range [begin, end), only a single-pass result is
+            // streamed, partial sums are read again by the next pass
+            template <class Stencil>
+            struct pass {
+                Stencil stencil;
+                value_type *dst;
+                int begin, end;
+                bool nontemporal;
+
+                template <int Fields, class Layout>
+                void run(const Layout &src, bool accumulate, bool last) const {
+                    const multifield::fields_view<Fields, Layout> s{src};
+                    const Stencil st = stencil;
+                    const value_type *d = dst;
+                    if (accumulate)
+                        store_range<false>(
+                            dst, begin, end, [=](int i) MULTIFIELD_INLINE_LAMBDA { return d[i] + st(s, i); });
+                    else if (last && nontemporal)
+                        store_range<true>(dst, begin, end, [=](int i) MULTIFIELD_INLINE_LAMBDA { return st(s, i); });
+                    else
+                        store_range<false>(dst, begin, end, [=](int i) MULTIFIELD_INLINE_LAMBDA { return st(s, i); });
+                }
+            };
+
+            // each thread fences its own streaming stores before the implicit barrier
+            template <class Stencil>
+            void run_stencil() {
+                const auto src = this->soa_fields();
+                constexpr int chunk = 4096;
+                const int last = this->index(this->isize() - 1, this->jsize() - 1, this->ksize() - 1);
+                const Stencil stencil{this->istride(), this->jstride(), this->kstride()};
+                const int fields = this->fields();
+                const int per_pass = this->fields_per_pass();
+                const bool nontemporal = m_policy == store_policy::nontemporal;
+                value_type *dst = this->dst();
+
+#pragma omp parallel
+                {
+#pragma omp for schedule(static)
+                    for (int begin = 0; begin <= last; begin += chunk) {
+                        const pass<Stencil> p{stencil, dst, begin, std::min(begin + chunk, last + 1), nontemporal};
+                        multifield::run_passes(p, src, fields, per_pass);
+                    }
+                    if (nontemporal)
+                        _mm_sfence();
+                }
+            }
+
+            store_policy m_policy;
+        };
+
+    } // namespace x86
+
+} // namespace platform
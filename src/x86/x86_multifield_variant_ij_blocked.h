@@ -0,0 +1,97 @@
+#pragma once
+
+#include "multifield_kernel.h"
+#include "x86/x86_basic_multifield_variant.h"
+
+namespace platform {
+
+    namespace x86 {
+
+        template <class Platform, class ValueType>
+        class multifield_variant_ij_blocked final : public x86_basic_multifield_variant<Platform, ValueType> {
+          public:
+            using value_type = ValueType;
+
+            multifield_variant_ij_blocked(const arguments_map &args)
+                : x86_basic_multifield_variant<Platform, ValueType>(args, parse_field_layout(args.get("layout"))),
+                  m_iblocksize(args.get<int>("i-blocksize")), m_jblocksize(args.get<int>("j-blocksize")) {
+                if (m_iblocksize <= 0 || m_jblocksize <= 0)
+                    throw ERROR("invalid block size");
+                if (this->istride() != 1)
+                    throw ERROR("this variant is only compatible with unit i-stride layout");
+            }
+
+            void copy() override { run_stencil<multifield::copy>(); }
+            void copyi() override { run_stencil<multifield::copyi>(); }
+            void copyj() override { run_stencil<multifield::copyj>(); }
+            void copyk() override { run_stencil<multifield::copyk>(); }
+            void avgi() override { run_stencil<multifield::avgi>(); }
+            void avgj() override { run_stencil<multifield::avgj>(); }
+            void avgk() override { run_stencil<multifield::avgk>(); }
+            void sumi() override { run_stencil<multifield::sumi>(); }
+            void sumj() override { run_stencil<multifield::sumj>(); }
+            void sumk() override { run_stencil<multifield::sumk>(); }
+            void lapij() override { run_stencil<multifield::lapij>(); }
+
+          private:
+            // one pass over Fields fields on the block [ib, imax) x [jb, jmax) x [0, ksize)
+            template <class Stencil>
+            struct pass {
+                Stencil stencil;
+                value_type *dst;
+                int ib, imax, jb, jmax, ksize;
+
+                template <int Fields, class Layout>
+                void run(const Layout &src, bool accumulate, bool) const {
+                    for (int k = 0; k < ksize; ++k) {
+                        for (int j = jb; j < jmax; ++j) {
+                            const int row = j * stencil.jstride + k * stencil.kstride;
+                            multifield::apply<Fields>(src, stencil, dst, row + ib, row + imax, accumulate);
+                        }
+                    }
+                }
+            };
+
+            template <class Stencil>
+            void run_stencil() {
+                if (this->layout() == field_layout::soa)
+                    run_stencil<Stencil>(this->soa_fields());
+                else if (this->layout() == field_layout::aos)
+                    run_stencil<Stencil>(this->aos_fields());
+                else
+                    run_stencil<Stencil>(this->aosoa_fields());
+            }
+
+            // static schedule hands out contiguous chunks of the collapsed (jb, ib) space,
+            // so neighbouring blocks (sharing halo lines) stay on the same core
+            template <class Stencil, class Layout>
+            void run_stencil(const Layout &src) {
+                const int isize = this->isize();
+                const int jsize = this->jsize();
+                const int ksize = this->ksize();
+                const Stencil stencil{1, this->jstride(), this->kstride()};
+                const int fields = this->fields();
+                const int per_pass = this->fields_per_pass();
+                value_type *dst = this->dst();
+
+#pragma omp parallel for collapse(2) schedule(static)
+                for (int jb = 0; jb < jsize; jb += m_jblocksize) {
+                    for (int ib = 0; ib < isize; ib += m_iblocksize) {
+                        const pass<Stencil> p{stencil,
+                            dst,
+                            ib,
+                            std::min(ib + m_iblocksize, isize),
+                            jb,
+                            std::min(jb + m_jblocksize, jsize),
+                            ksize};
+                        multifield::run_passes(p, src, fields, per_pass);
+                    }
+                }
+            }
+
+            int m_iblocksize, m_jblocksize;
+        };
+
+    } // namespace x86
+
+} // namespace platform
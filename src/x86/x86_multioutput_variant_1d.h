@@ -0,0 +1,71 @@
+#pragma once
+
+#include <algorithm>
+
+#include "multifield_kernel.h"
+#include "x86/x86_basic_multioutput_variant.h"
+
+namespace platform {
+
+    namespace x86 {
+
+        template <class Platform, class ValueType>
+        class multioutput_variant_1d final : public x86_basic_multioutput_variant<Platform, ValueType> {
+          public:
+            using value_type = ValueType;
+
+            multioutput_variant_1d(const arguments_map &args)
+                : x86_basic_multioutput_variant<Platform, ValueType>(args) {}
+
+            void copy() override { run_stencil<multifield::copy>(); }
+            void avgi() override { run_stencil<multifield::avgi>(); }
+            void avgj() override { run_stencil<multifield::avgj>(); }
+            void avgk() override { run_stencil<multifield::avgk>(); }
+            void lapij() override { run_stencil<multifield::lapij>(); }
+
+          private:
+            // one pass over Fields input fields on the index range [begin, end), the stencil is evaluated
+            // once per strip into a buffer that then feeds all outputs
+            template <class Stencil>
+            struct pass {
+                Stencil stencil;
+                value_type *const *dst;
+                int fields_out, begin, end;
+
+                template <int Fields, class Layout>
+                void run(const Layout &src, bool accumulate, bool) const {
+                    constexpr int strip = 256;
+                    const multifield::fields_view<Fields, Layout> s{src};
+                    alignas(64) value_type values[strip];
+                    for (int first = begin; first < end; first += strip) {
+                        const int n = std::min(strip, end - first);
+#pragma omp simd
+                        for (int l = 0; l < n; ++l)
+                            values[l] = stencil(s, first + l);
+                        multioutput_variant_1d::store_outputs(dst, fields_out, values, first, n, accumulate);
+                    }
+                }
+            };
+
+            template <class Stencil>
+            void run_stencil() {
+                constexpr int chunk = 4096;
+                const int last = this->index(this->isize() - 1, this->jsize() - 1, this->ksize() - 1);
+                const Stencil stencil{this->istride(), this->jstride(), this->kstride()};
+                const auto src = this->src_fields();
+                const auto dst = this->dst_pointers();
+                const int fields_in = this->fields_in();
+                const int fields_out = this->fields_out();
+                const int per_pass = this->fields_per_pass();
+
+#pragma omp parallel for schedule(static)
+                for (int begin = 0; begin <= last; begin += chunk) {
+                    const pass<Stencil> p{stencil, dst.data(), fields_out, begin, std::min(begin + chunk, last + 1)};
+                    multifield::run_passes(p, src, fields_in, per_pass);
+                }
+            }
+        };
+
+    } // namespace x86
+
+} // namespace platform
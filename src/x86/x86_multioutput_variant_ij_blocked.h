@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+
+#include "multifield_kernel.h"
+#include "x86/x86_basic_multioutput_variant.h"
+
+namespace platform {
+
+    namespace x86 {
+
+        template <class Platform, class ValueType>
+        class multioutput_variant_ij_blocked final : public x86_basic_multioutput_variant<Platform, ValueType> {
+          public:
+            using value_type = ValueType;
+
+            multioutput_variant_ij_blocked(const arguments_map &args)
+                : x86_basic_multioutput_variant<Platform, ValueType>(args), m_iblocksize(args.get<int>("i-blocksize")),
+                  m_jblocksize(args.get<int>("j-blocksize")) {
+                if (m_iblocksize <= 0 || m_jblocksize <= 0)
+                    throw ERROR("invalid block size");
+                if (this->istride() != 1)
+                    throw ERROR("this variant is only compatible with unit i-stride layout");
+            }
+
+            void copy() override { run_stencil<multifield::copy>(); }
+            void avgi() override { run_stencil<multifield::avgi>(); }
+            void avgj() override { run_stencil<multifield::avgj>(); }
+            void avgk() override { run_stencil<multifield::avgk>(); }
+            void lapij() override { run_stencil<multifield::lapij>(); }
+
+          private:
+            // one pass over Fields input fields on the block [ib, imax) x [jb, jmax) x [0, ksize), the stencil is
+            // evaluated once per row strip into a buffer that then feeds all outputs
+            template <class Stencil>
+            struct pass {
+                Stencil stencil;
+                value_type *const *dst;
+                int fields_out, ib, imax, jb, jmax, ksize;
+
+                template <int Fields, class Layout>
+                void run(const Layout &src, bool accumulate, bool) const {
+                    constexpr int strip = 256;
+                    const multifield::fields_view<Fields, Layout> s{src};
+                    alignas(64) value_type values[strip];
+                    for (int k = 0; k < ksize; ++k) {
+                        for (int j = jb; j < jmax; ++j) {
+                            const int row = j * stencil.jstride + k * stencil.kstride;
+                            for (int is = ib; is < imax; is += strip) {
+                                const int first = row + is;
+                                const int n = std::min(strip, imax - is);
+#pragma omp simd
+                                for (int l = 0; l < n; ++l)
+                                    values[l] = stencil(s, first + l);
+                                multioutput_variant_ij_blocked::store_outputs(
+                                    dst, fields_out, values, first, n, accumulate);
+                            }
+                        }
+                    }
+                }
+            };
+
+            // static schedule hands out contiguous chunks of the collapsed (jb, ib) space,
+            // so neighbouring blocks (sharing halo lines) stay on the same core
+            template <class Stencil>
+            void run_stencil() {
+                const int isize = this->isize();
+                const int jsize = this->jsize();
+                const int ksize = this->ksize();
+                const Stencil stencil{1, this->jstride(), this->kstride()};
+                const auto src = this->src_fields();
+                const auto dst = this->dst_pointers();
+                const int fields_in = this->fields_in();
+                const int fields_out = this->fields_out();
+                const int per_pass = this->fields_per_pass();
+
+#pragma omp parallel for collapse(2) schedule(static)
+                for (int jb = 0; jb < jsize; jb += m_jblocksize) {
+                    for (int ib = 0; ib < isize; ib += m_iblocksize) {
+                        const pass<Stencil> p{stencil,
+                            dst.data(),
+                            fields_out,
+                            ib,
+                            std::min(ib + m_iblocksize, isize),
+                            jb,
+                            std::min(jb + m_jblocksize, jsize),
+                            ksize};
+                        multifield::run_passes(p, src, fields_in, per_pass);
+                    }
+                }
+            }
+
+            int m_iblocksize, m_jblocksize;
+        };
+
+    } // namespace x86
+
+} // namespace platform
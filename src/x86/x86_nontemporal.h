@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <omp.h>
+
+#include "except.h"
+#include "x86/x86_simd.h"
+
+namespace platform {
+
+    namespace x86 {
+
+        enum class store_policy { regular, nontemporal };
+
+        // 'auto' streams only if the working set does not fit into the last level cache anyway
+        inline store_policy parse_store_policy(
+            const std::string &policy, std::size_t working_set_bytes, std::size_t llc_bytes) {
+            if (policy == "regular")
+                return store_policy::regular;
+            if (policy == "nontemporal")
+                return store_policy::nontemporal;
+            if (policy == "auto")
+                return working_set_bytes > llc_bytes ? store_policy::nontemporal : store_policy::regular;
+            throw ERROR("invalid store policy '" + policy + "'");
+        }
+
+        // stores kernel(i) to dst[i] for i in [first, last): scalar peel until dst is vector aligned,
+        // full-width (streaming) vector stores for the body, scalar remainder; kernel may read dst[i]
+        template <bool NonTemporal, class ValueType, class Kernel>
+        inline void store_range(ValueType *dst, int first, int last, const Kernel &kernel) {
+            using vec = simd<ValueType>;
+            constexpr int width = vec::width;
+
+            int i = first;
+            while (i < last && reinterpret_cast<std::uintptr_t>(dst + i) % (width * sizeof(ValueType)) != 0) {
+                dst[i] = kernel(i);
+                ++i;
+            }
+
+            for (; i + width <= last; i += width) {
+                alignas(64) ValueType tmp[width];
+#pragma omp simd
+                for (int l = 0; l < width; ++l)
+                    tmp[l] = kernel(i + l);
+                if (NonTemporal)
+                    vec::stream(dst + i, vec::load(tmp));
+                else
+                    vec::store(dst + i, vec::load(tmp));
+            }
+
+            for (; i < last; ++i)
+                dst[i] = kernel(i);
+        }
+
+        // one chunk (multiple of the vector width) per thread, each thread fences its own streaming stores
+        template <bool NonTemporal, class ValueType, class Kernel>
+        inline void parallel_store_range(ValueType *__restrict__ dst, int first, int last, const Kernel &kernel) {
+            constexpr int width = simd<ValueType>::width;
+#pragma omp parallel
+            {
+                const int threads = omp_get_num_threads();
+                const int thread = omp_get_thread_num();
+                const int chunk = ((last - first + threads - 1) / threads + width - 1) / width * width;
+                const int begin = first + thread * chunk < last ? first + thread * chunk : last;
+                const int end = begin + chunk < last ? begin + chunk : last;
+
+                store_range<NonTemporal>(dst, begin, end, kernel);
+                if (NonTemporal)
+                    _mm_sfence();
+            }
+        }
+
+    } // namespace x86
+
+} // namespace platform
@@ -1,13 +1,43 @@
 #include <chrono>
 
+#include <unistd.h>
+
 #include "x86/x86_platform.h"
 
 #include "x86/x86_hdiff_variant_ij_blocked.h"
 #include "x86/x86_hdiff_variant_k_outermost.h"
+#include "x86/x86_hdiff_variant_ij_blocked_k_innermost.h"
+#include "x86/x86_hdiff_variant_ij_blocked_non_red.h"
+#include "x86/x86_hdiff_variant_ij_blocked_non_red_persistent.h"
+#include "x86/x86_hdiff_variant_ij_blocked_unrolled.h"
+#include "x86/x86_hdiff_variant_task_graph.h"
+#include "x86/x86_hdiff_variant_stage_graph.h"
 #include "x86/x86_hdiff_variant_ij_blocked_private_halo.h"
 #include "x86/x86_hdiff_variant_ij_blocked_stacked_layout.h"
+#include "x86/x86_hdiff_variant_ij_blocked_thread_private.h"
+#include "x86/x86_hdiff_variant_ij_blocked_fused.h"
+#include "x86/x86_hdiff_variant_temporal_blocked.h"
+#include "x86/x86_hdiff_variant_simd.h"
+#include "x86/x86_hdiff_variant_mixed_precision.h"
+#include "x86/x86_hdiff_variant_two_level_blocked.h"
 #include "x86/x86_hdiff_variant_simple.h"
+#include "x86/x86_multifield_variant_1d.h"
+#include "x86/x86_multifield_variant_1d_nontemporal.h"
+#include "x86/x86_multifield_variant_ij_blocked.h"
+#include "x86/x86_multioutput_variant_1d.h"
+#include "x86/x86_multioutput_variant_ij_blocked.h"
+#include "x86/x86_vadv_variant_2d.h"
+#include "x86/x86_vadv_variant_fused.h"
+#include "x86/x86_vadv_variant_ij_blocked.h"
+#include "x86/x86_vadv_variant_local.h"
+#include "x86/x86_vadv_variant_pcr.h"
+#include "x86/x86_vadv_variant_simd.h"
 #include "x86/x86_variant_1d.h"
+#include "x86/x86_variant_1d_nontemporal.h"
+#include "x86/x86_variant_ij_blocked.h"
+#include "x86/x86_variant_ij_blocked_specialized.h"
+#include "x86/x86_variant_ij_blocked_unrolled.h"
+#include "x86/x86_variant_ijk_blocked.h"
 
 namespace platform {
 
@@ -22,9 +52,33 @@ namespace platform {
             // TODO: implement cache conflict check
         }
 
+        std::size_t x86_platform_base::llc_size() {
+            long size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+            if (size <= 0)
+                size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+            // conservative guess if the C library can not tell
+            return size > 0 ? size : std::size_t(8) * 1024 * 1024;
+        }
+
         void x86_standard::setup(arguments &args) {
             arguments &pargs = args.command(name, "variant");
             pargs.command("1d");
+            pargs.command("1d-nontemporal").add("store", "store policy (regular, nontemporal, auto)", "nontemporal");
+            pargs.command("ij-blocked")
+                .add("i-blocksize", "block size in i-direction", "32")
+                .add("j-blocksize", "block size in j-direction", "8");
+            pargs.command("ij-blocked-unrolled")
+                .add("i-blocksize", "block size in i-direction", "32")
+                .add("j-blocksize", "block size in j-direction", "8")
+                .add("unroll-j", "number of j-rows of lapij per inner iteration", "8");
+            pargs.command("ij-blocked-specialized")
+                .add("i-blocksize", "block size in i-direction", "32")
+                .add("j-blocksize", "block size in j-direction", "8")
+                .add("specialize", "source of compile-time sizes and strides (none, preset, jit)", "jit");
+            pargs.command("ijk-blocked")
+                .add("i-blocksize", "block size in i-direction", "32")
+                .add("j-blocksize", "block size in j-direction", "8")
+                .add("k-blocksize", "block size in k-direction", "8");
             pargs.command("hdiff-simple");
             pargs.command("hdiff-ij-blocked")
                 .add("i-blocksize", "block size in i-direction", "32")
@@ -32,12 +86,93 @@ namespace platform {
             pargs.command("hdiff-k-outermost")
                 .add("i-blocksize", "block size in i-direction", "32")
                 .add("j-blocksize", "block size in j-direction", "8");
+            pargs.command("hdiff-ij-blocked-k-innermost")
+                .add("i-blocksize", "block size in i-direction", "64")
+                .add("j-blocksize", "block size in j-direction", "8");
+            pargs.command("hdiff-ij-blocked-non-red")
+                .add("i-blocksize", "block size in i-direction", "256")
+                .add("j-blocksize", "block size in j-direction", "8");
+            pargs.command("hdiff-ij-blocked-non-red-persistent")
+                .add("i-blocksize", "block size in i-direction", "256")
+                .add("j-blocksize", "block size in j-direction", "8");
+            pargs.command("hdiff-ij-blocked-unrolled")
+                .add("i-blocksize", "block size in i-direction", "256")
+                .add("j-blocksize", "block size in j-direction", "8")
+                .add("unroll-j", "number of j-rows of lap per inner iteration", "8");
+            pargs.command("hdiff-task-graph")
+                .add("i-blocksize", "task block size in i-direction", "64")
+                .add("j-blocksize", "task block size in j-direction", "16")
+                .add("k-blocksize", "task block size in k-direction", "4");
+            pargs.command("hdiff-stage-graph")
+                .add("i-blocksize", "block size in i-direction", "64")
+                .add("j-blocksize", "block size in j-direction", "8")
+                .add("lap-placement", "placement of lap (full, block or inline)", "block")
+                .add("flux-placement", "placement of flx and fly (full, block or inline)", "block");
             pargs.command("hdiff-ij-blocked-private-halo")
                 .add("i-blocksize", "block size in i-direction", "32")
                 .add("j-blocksize", "block size in j-direction", "8");                
             pargs.command("hdiff-ij-blocked-stacked-layout")
                 .add("i-blocksize", "block size in i-direction", "32")
                 .add("j-blocksize", "block size in j-direction", "8");                
+            pargs.command("hdiff-ij-blocked-thread-private")
+                .add("i-blocksize", "block size in i-direction", "32")
+                .add("j-blocksize", "block size in j-direction", "8");
+            pargs.command("hdiff-ij-blocked-fused")
+                .add("i-blocksize", "block size in i-direction", "256")
+                .add("j-blocksize", "block size in j-direction", "32");
+            pargs.command("hdiff-temporal-blocked")
+                .add("i-blocksize", "block size in i-direction", "256")
+                .add("j-blocksize", "block size in j-direction", "64")
+                .add("t-blocksize", "number of time steps per tile", "8");
+            pargs.command("hdiff-simd")
+                .add("i-blocksize", "block size in i-direction", "256")
+                .add("j-blocksize", "block size in j-direction", "32");
+            pargs.command("hdiff-mixed-precision")
+                .add("i-blocksize", "block size in i-direction", "32")
+                .add("j-blocksize", "block size in j-direction", "8")
+                .add("temp-precision", "precision of lap, flx and fly (single or double)", "single");
+            pargs.command("hdiff-two-level-blocked")
+                .add("i-blocksize", "L2 tile size in i-direction", "256")
+                .add("j-blocksize", "L2 tile size in j-direction", "64")
+                .add("i-subblocksize", "L1 sub-tile size in i-direction", "64")
+                .add("j-subblocksize", "L1 sub-tile size in j-direction", "8");
+            pargs.command("multifield-1d")
+                .add("fields", "number of fields", "5")
+                .add("fields-per-pass", "maximum number of fields read in a single pass", "8")
+                .add("layout", "field storage layout (soa, aos, aosoa)", "soa");
+            pargs.command("multifield-ij-blocked")
+                .add("fields", "number of fields", "5")
+                .add("fields-per-pass", "maximum number of fields read in a single pass", "8")
+                .add("layout", "field storage layout (soa, aos, aosoa)", "soa")
+                .add("i-blocksize", "block size in i-direction", "32")
+                .add("j-blocksize", "block size in j-direction", "8");
+            pargs.command("multifield-1d-nontemporal")
+                .add("fields", "number of fields", "5")
+                .add("fields-per-pass", "maximum number of fields read in a single pass", "8")
+                .add("store", "store policy (regular, nontemporal, auto)", "nontemporal");
+            pargs.command("multioutput-1d")
+                .add("fields-in", "number of input fields", "5")
+                .add("fields-out", "number of output fields", "3")
+                .add("fields-per-pass", "maximum number of input fields read in a single pass", "8");
+            pargs.command("multioutput-ij-blocked")
+                .add("fields-in", "number of input fields", "5")
+                .add("fields-out", "number of output fields", "3")
+                .add("fields-per-pass", "maximum number of input fields read in a single pass", "8")
+                .add("i-blocksize", "block size in i-direction", "32")
+                .add("j-blocksize", "block size in j-direction", "8");
+            pargs.command("vadv-2d");
+            pargs.command("vadv-ij-blocked")
+                .add("i-blocksize", "block size in i-direction", "32")
+                .add("j-blocksize", "block size in j-direction", "8");
+            pargs.command("vadv-simd");
+            pargs.command("vadv-fused")
+                .add("i-blocksize", "block size in i-direction", "32")
+                .add("j-blocksize", "block size in j-direction", "8");
+            pargs.command("vadv-local").add("i-blocksize", "block size in i-direction", "64");
+            pargs.command("vadv-pcr")
+                .add("solver", "tridiagonal solver: thomas, pcr, hybrid or auto", "auto")
+                .add("pcr-steps", "number of PCR steps before Thomas for the hybrid solver", "2")
+                .add("columns-per-thread", "minimum number of independent systems per thread for auto", "16");
         }
 
         variant_base *x86_standard::create_variant(const arguments_map &args) {
@@ -50,29 +185,151 @@ namespace platform {
             if (prec == "single") {
                 if (var == "1d")
                     return new variant_1d<x86_standard, float>(args);
+                if (var == "1d-nontemporal")
+                    return new variant_1d_nontemporal<x86_standard, float>(args);
+                if (var == "ij-blocked")
+                    return new variant_ij_blocked<x86_standard, float>(args);
+                if (var == "ij-blocked-unrolled")
+                    return new variant_ij_blocked_unrolled<x86_standard, float>(args);
+                if (var == "ij-blocked-specialized")
+                    return new variant_ij_blocked_specialized<x86_standard, float>(args);
+                if (var == "ijk-blocked")
+                    return new variant_ijk_blocked<x86_standard, float>(args);
                 if (var == "hdiff-simple")
                     return new x86_hdiff_variant_simple<x86_standard, float>(args);
                 if (var == "hdiff-ij-blocked")
                     return new x86_hdiff_variant_ij_blocked<x86_standard, float>(args);
                 if (var == "hdiff-k-outermost")
                     return new x86_hdiff_variant_k_outermost<x86_standard, float>(args);
+                if (var == "hdiff-ij-blocked-k-innermost")
+                    return new x86_hdiff_variant_ij_blocked_k_innermost<x86_standard, float>(args);
+                if (var == "hdiff-ij-blocked-non-red")
+                    return new x86_hdiff_variant_ij_blocked_non_red<x86_standard, float>(args);
+                if (var == "hdiff-ij-blocked-non-red-persistent")
+                    return new x86_hdiff_variant_ij_blocked_non_red_persistent<x86_standard, float>(args);
+                if (var == "hdiff-ij-blocked-unrolled")
+                    return new x86_hdiff_variant_ij_blocked_unrolled<x86_standard, float>(args);
+                if (var == "hdiff-task-graph")
+                    return new x86_hdiff_variant_task_graph<x86_standard, float>(args);
+                if (var == "hdiff-stage-graph")
+                    return new x86_hdiff_variant_stage_graph<x86_standard, float>(args);
                 if (var == "hdiff-ij-blocked-private-halo")
                     return new x86_hdiff_variant_ij_blocked_private_halo<x86_standard, float>(args);                
                 if (var == "hdiff-ij-blocked-stacked-layout")
                     return new x86_hdiff_variant_ij_blocked_stacked_layout<x86_standard, float>(args);                
+                if (var == "hdiff-ij-blocked-thread-private")
+                    return new x86_hdiff_variant_ij_blocked_thread_private<x86_standard, float>(args);
+                if (var == "hdiff-ij-blocked-fused")
+                    return new x86_hdiff_variant_ij_blocked_fused<x86_standard, float>(args);
+                if (var == "hdiff-temporal-blocked")
+                    return new x86_hdiff_variant_temporal_blocked<x86_standard, float>(args);
+                if (var == "hdiff-simd")
+                    return new x86_hdiff_variant_simd<x86_standard, float>(args);
+                if (var == "hdiff-mixed-precision") {
+                    if (args.get("temp-precision") == "single")
+                        return new x86_hdiff_variant_mixed_precision<x86_standard, float, float>(args);
+                    if (args.get("temp-precision") == "double")
+                        return new x86_hdiff_variant_mixed_precision<x86_standard, float, double>(args);
+                    throw ERROR("invalid temp-precision '" + args.get("temp-precision") + "'");
+                }
+                if (var == "hdiff-two-level-blocked")
+                    return new x86_hdiff_variant_two_level_blocked<x86_standard, float>(args);
+                if (var == "multifield-1d")
+                    return new multifield_variant_1d<x86_standard, float>(args);
+                if (var == "multifield-ij-blocked")
+                    return new multifield_variant_ij_blocked<x86_standard, float>(args);
+                if (var == "multifield-1d-nontemporal")
+                    return new multifield_variant_1d_nontemporal<x86_standard, float>(args);
+                if (var == "multioutput-1d")
+                    return new multioutput_variant_1d<x86_standard, float>(args);
+                if (var == "multioutput-ij-blocked")
+                    return new multioutput_variant_ij_blocked<x86_standard, float>(args);
+                if (var == "vadv-2d")
+                    return new x86_vadv_variant_2d<x86_standard, float>(args);
+                if (var == "vadv-ij-blocked")
+                    return new x86_vadv_variant_ij_blocked<x86_standard, float>(args);
+                if (var == "vadv-simd")
+                    return new x86_vadv_variant_simd<x86_standard, float>(args);
+                if (var == "vadv-fused")
+                    return new x86_vadv_variant_fused<x86_standard, float>(args);
+                if (var == "vadv-local")
+                    return new x86_vadv_variant_local<x86_standard, float>(args);
+                if (var == "vadv-pcr")
+                    return new x86_vadv_variant_pcr<x86_standard, float>(args);
             } else if (prec == "double") {
                 if (var == "1d")
                     return new variant_1d<x86_standard, double>(args);
+                if (var == "1d-nontemporal")
+                    return new variant_1d_nontemporal<x86_standard, double>(args);
+                if (var == "ij-blocked")
+                    return new variant_ij_blocked<x86_standard, double>(args);
+                if (var == "ij-blocked-unrolled")
+                    return new variant_ij_blocked_unrolled<x86_standard, double>(args);
+                if (var == "ij-blocked-specialized")
+                    return new variant_ij_blocked_specialized<x86_standard, double>(args);
+                if (var == "ijk-blocked")
+                    return new variant_ijk_blocked<x86_standard, double>(args);
                 if (var == "hdiff-simple")
                     return new x86_hdiff_variant_simple<x86_standard, double>(args);
                 if (var == "hdiff-ij-blocked")
                     return new x86_hdiff_variant_ij_blocked<x86_standard, double>(args);
                 if (var == "hdiff-k-outermost")
                     return new x86_hdiff_variant_k_outermost<x86_standard, double>(args);
+                if (var == "hdiff-ij-blocked-k-innermost")
+                    return new x86_hdiff_variant_ij_blocked_k_innermost<x86_standard, double>(args);
+                if (var == "hdiff-ij-blocked-non-red")
+                    return new x86_hdiff_variant_ij_blocked_non_red<x86_standard, double>(args);
+                if (var == "hdiff-ij-blocked-non-red-persistent")
+                    return new x86_hdiff_variant_ij_blocked_non_red_persistent<x86_standard, double>(args);
+                if (var == "hdiff-ij-blocked-unrolled")
+                    return new x86_hdiff_variant_ij_blocked_unrolled<x86_standard, double>(args);
+                if (var == "hdiff-task-graph")
+                    return new x86_hdiff_variant_task_graph<x86_standard, double>(args);
+                if (var == "hdiff-stage-graph")
+                    return new x86_hdiff_variant_stage_graph<x86_standard, double>(args);
                 if (var == "hdiff-ij-blocked-private-halo")
                     return new x86_hdiff_variant_ij_blocked_private_halo<x86_standard, double>(args);
                 if (var == "hdiff-ij-blocked-stacked-layout")
                     return new x86_hdiff_variant_ij_blocked_stacked_layout<x86_standard, double>(args);
+                if (var == "hdiff-ij-blocked-thread-private")
+                    return new x86_hdiff_variant_ij_blocked_thread_private<x86_standard, double>(args);
+                if (var == "hdiff-ij-blocked-fused")
+                    return new x86_hdiff_variant_ij_blocked_fused<x86_standard, double>(args);
+                if (var == "hdiff-temporal-blocked")
+                    return new x86_hdiff_variant_temporal_blocked<x86_standard, double>(args);
+                if (var == "hdiff-simd")
+                    return new x86_hdiff_variant_simd<x86_standard, double>(args);
+                if (var == "hdiff-mixed-precision") {
+                    if (args.get("temp-precision") == "single")
+                        return new x86_hdiff_variant_mixed_precision<x86_standard, double, float>(args);
+                    if (args.get("temp-precision") == "double")
+                        return new x86_hdiff_variant_mixed_precision<x86_standard, double, double>(args);
+                    throw ERROR("invalid temp-precision '" + args.get("temp-precision") + "'");
+                }
+                if (var == "hdiff-two-level-blocked")
+                    return new x86_hdiff_variant_two_level_blocked<x86_standard, double>(args);
+                if (var == "multifield-1d")
+                    return new multifield_variant_1d<x86_standard, double>(args);
+                if (var == "multifield-ij-blocked")
+                    return new multifield_variant_ij_blocked<x86_standard, double>(args);
+                if (var == "multifield-1d-nontemporal")
+                    return new multifield_variant_1d_nontemporal<x86_standard, double>(args);
+                if (var == "multioutput-1d")
+                    return new multioutput_variant_1d<x86_standard, double>(args);
+                if (var == "multioutput-ij-blocked")
+                    return new multioutput_variant_ij_blocked<x86_standard, double>(args);
+                if (var == "vadv-2d")
+                    return new x86_vadv_variant_2d<x86_standard, double>(args);
+                if (var == "vadv-ij-blocked")
+                    return new x86_vadv_variant_ij_blocked<x86_standard, double>(args);
+                if (var == "vadv-simd")
+                    return new x86_vadv_variant_simd<x86_standard, double>(args);
+                if (var == "vadv-fused")
+                    return new x86_vadv_variant_fused<x86_standard, double>(args);
+                if (var == "vadv-local")
+                    return new x86_vadv_variant_local<x86_standard, double>(args);
+                if (var == "vadv-pcr")
+                    return new x86_vadv_variant_pcr<x86_standard, double>(args);
             }
 
             return nullptr;
@@ -10,6 +10,7 @@ namespace platform {
         struct x86_platform_base {
             static void flush_cache();
             static void check_cache_conflicts(const std::string &stride_name, std::ptrdiff_t byte_stride);
+            static std::size_t llc_size();
         };
 
         struct x86_standard : x86_platform_base {
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <immintrin.h>
+
+namespace platform {
+
+    namespace x86 {
+
+        // thin wrappers around the widest vector registers enabled at compile time (-mavx512f, -mavx or plain SSE2),
+        // mask(n) selects the first n lanes for the masked unaligned loads/stores of remainders; fmadd (a * b + c),
+        // fnmadd (c - a * b) and fnmsub (-a * b - c) are only fused if FMA is enabled, like contracted scalar code
+        // zero_where_positive(c, x) is the branch-free select c > 0 ? 0 : x
+        template <class ValueType>
+        struct simd;
+
+#if defined(__AVX512F__)
+        template <>
+        struct simd<float> {
+            using type = __m512;
+            static constexpr int width = 16;
+
+            static type load(const float *p) { return _mm512_load_ps(p); }
+            static void store(float *p, type v) { _mm512_store_ps(p, v); }
+            static void stream(float *p, type v) { _mm512_stream_ps(p, v); }
+            static type loadu(const float *p) { return _mm512_loadu_ps(p); }
+            static void storeu(float *p, type v) { _mm512_storeu_ps(p, v); }
+            static type set1(float x) { return _mm512_set1_ps(x); }
+            static type add(type a, type b) { return _mm512_add_ps(a, b); }
+            static type sub(type a, type b) { return _mm512_sub_ps(a, b); }
+            static type mul(type a, type b) { return _mm512_mul_ps(a, b); }
+            static type div(type a, type b) { return _mm512_div_ps(a, b); }
+            static type fmadd(type a, type b, type c) { return _mm512_fmadd_ps(a, b, c); }
+            static type fnmadd(type a, type b, type c) { return _mm512_fnmadd_ps(a, b, c); }
+            static type fnmsub(type a, type b, type c) { return _mm512_fnmsub_ps(a, b, c); }
+
+            static type zero_where_positive(type c, type x) {
+                return _mm512_maskz_mov_ps(_mm512_cmp_ps_mask(c, _mm512_setzero_ps(), _CMP_NGT_UQ), x);
+            }
+
+            using mask_type = __mmask16;
+            static mask_type mask(int n) { return n >= width ? mask_type(0xffff) : mask_type((1u << n) - 1); }
+            static type maskz_loadu(mask_type m, const float *p) { return _mm512_maskz_loadu_ps(m, p); }
+            static void mask_storeu(float *p, mask_type m, type v) { _mm512_mask_storeu_ps(p, m, v); }
+        };
+
+        template <>
+        struct simd<double> {
+            using type = __m512d;
+            static constexpr int width = 8;
+
+            static type load(const double *p) { return _mm512_load_pd(p); }
+            static void store(double *p, type v) { _mm512_store_pd(p, v); }
+            static void stream(double *p, type v) { _mm512_stream_pd(p, v); }
+            static type loadu(const double *p) { return _mm512_loadu_pd(p); }
+            static void storeu(double *p, type v) { _mm512_storeu_pd(p, v); }
+            static type set1(double x) { return _mm512_set1_pd(x); }
+            static type add(type a, type b) { return _mm512_add_pd(a, b); }
+            static type sub(type a, type b) { return _mm512_sub_pd(a, b); }
+            static type mul(type a, type b) { return _mm512_mul_pd(a, b); }
+            static type div(type a, type b) { return _mm512_div_pd(a, b); }
+            static type fmadd(type a, type b, type c) { return _mm512_fmadd_pd(a, b, c); }
+            static type fnmadd(type a, type b, type c) { return _mm512_fnmadd_pd(a, b, c); }
+            static type fnmsub(type a, type b, type c) { return _mm512_fnmsub_pd(a, b, c); }
+
+            static type zero_where_positive(type c, type x) {
+                return _mm512_maskz_mov_pd(_mm512_cmp_pd_mask(c, _mm512_setzero_pd(), _CMP_NGT_UQ), x);
+            }
+
+            using mask_type = __mmask8;
+            static mask_type mask(int n) { return n >= width ? mask_type(0xff) : mask_type((1u << n) - 1); }
+            static type maskz_loadu(mask_type m, const double *p) { return _mm512_maskz_loadu_pd(m, p); }
+            static void mask_storeu(double *p, mask_type m, type v) { _mm512_mask_storeu_pd(p, m, v); }
+        };
+#elif defined(__AVX__)
+        template <>
+        struct simd<float> {
+            using type = __m256;
+            static constexpr int width = 8;
+
+            static type load(const float *p) { return _mm256_load_ps(p); }
+            static void store(float *p, type v) { _mm256_store_ps(p, v); }
+            static void stream(float *p, type v) { _mm256_stream_ps(p, v); }
+            static type loadu(const float *p) { return _mm256_loadu_ps(p); }
+            static void storeu(float *p, type v) { _mm256_storeu_ps(p, v); }
+            static type set1(float x) { return _mm256_set1_ps(x); }
+            static type add(type a, type b) { return _mm256_add_ps(a, b); }
+            static type sub(type a, type b) { return _mm256_sub_ps(a, b); }
+            static type mul(type a, type b) { return _mm256_mul_ps(a, b); }
+            static type div(type a, type b) { return _mm256_div_ps(a, b); }
+#if defined(__FMA__)
+            static type fmadd(type a, type b, type c) { return _mm256_fmadd_ps(a, b, c); }
+            static type fnmadd(type a, type b, type c) { return _mm256_fnmadd_ps(a, b, c); }
+            static type fnmsub(type a, type b, type c) { return _mm256_fnmsub_ps(a, b, c); }
+#else
+            static type fmadd(type a, type b, type c) { return add(mul(a, b), c); }
+            static type fnmadd(type a, type b, type c) { return sub(c, mul(a, b)); }
+            static type fnmsub(type a, type b, type c) { return sub(sub(_mm256_setzero_ps(), mul(a, b)), c); }
+#endif
+
+            static type zero_where_positive(type c, type x) {
+                return _mm256_and_ps(_mm256_cmp_ps(c, _mm256_setzero_ps(), _CMP_NGT_UQ), x);
+            }
+
+            using mask_type = __m256i;
+            static mask_type mask(int n) {
+                return _mm256_castps_si256(
+                    _mm256_cmp_ps(_mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_ps(n), _CMP_LT_OQ));
+            }
+            static type maskz_loadu(mask_type m, const float *p) { return _mm256_maskload_ps(p, m); }
+            static void mask_storeu(float *p, mask_type m, type v) { _mm256_maskstore_ps(p, m, v); }
+        };
+
+        template <>
+        struct simd<double> {
+            using type = __m256d;
+            static constexpr int width = 4;
+
+            static type load(const double *p) { return _mm256_load_pd(p); }
+            static void store(double *p, type v) { _mm256_store_pd(p, v); }
+            static void stream(double *p, type v) { _mm256_stream_pd(p, v); }
+            static type loadu(const double *p) { return _mm256_loadu_pd(p); }
+            static void storeu(double *p, type v) { _mm256_storeu_pd(p, v); }
+            static type set1(double x) { return _mm256_set1_pd(x); }
+            static type add(type a, type b) { return _mm256_add_pd(a, b); }
+            static type sub(type a, type b) { return _mm256_sub_pd(a, b); }
+            static type mul(type a, type b) { return _mm256_mul_pd(a, b); }
+            static type div(type a, type b) { return _mm256_div_pd(a, b); }
+#if defined(__FMA__)
+            static type fmadd(type a, type b, type c) { return _mm256_fmadd_pd(a, b, c); }
+            static type fnmadd(type a, type b, type c) { return _mm256_fnmadd_pd(a, b, c); }
+            static type fnmsub(type a, type b, type c) { return _mm256_fnmsub_pd(a, b, c); }
+#else
+            static type fmadd(type a, type b, type c) { return add(mul(a, b), c); }
+            static type fnmadd(type a, type b, type c) { return sub(c, mul(a, b)); }
+            static type fnmsub(type a, type b, type c) { return sub(sub(_mm256_setzero_pd(), mul(a, b)), c); }
+#endif
+
+            static type zero_where_positive(type c, type x) {
+                return _mm256_and_pd(_mm256_cmp_pd(c, _mm256_setzero_pd(), _CMP_NGT_UQ), x);
+            }
+
+            using mask_type = __m256i;
+            static mask_type mask(int n) {
+                return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_setr_pd(0, 1, 2, 3), _mm256_set1_pd(n), _CMP_LT_OQ));
+            }
+            static type maskz_loadu(mask_type m, const double *p) { return _mm256_maskload_pd(p, m); }
+            static void mask_storeu(double *p, mask_type m, type v) { _mm256_maskstore_pd(p, m, v); }
+        };
+#else
+        template <>
+        struct simd<float> {
+            using type = __m128;
+            static constexpr int width = 4;
+
+            static type load(const float *p) { return _mm_load_ps(p); }
+            static void store(float *p, type v) { _mm_store_ps(p, v); }
+            static void stream(float *p, type v) { _mm_stream_ps(p, v); }
+            static type loadu(const float *p) { return _mm_loadu_ps(p); }
+            static void storeu(float *p, type v) { _mm_storeu_ps(p, v); }
+            static type set1(float x) { return _mm_set1_ps(x); }
+            static type add(type a, type b) { return _mm_add_ps(a, b); }
+            static type sub(type a, type b) { return _mm_sub_ps(a, b); }
+            static type mul(type a, type b) { return _mm_mul_ps(a, b); }
+            static type div(type a, type b) { return _mm_div_ps(a, b); }
+#if defined(__FMA__)
+            static type fmadd(type a, type b, type c) { return _mm_fmadd_ps(a, b, c); }
+            static type fnmadd(type a, type b, type c) { return _mm_fnmadd_ps(a, b, c); }
+            static type fnmsub(type a, type b, type c) { return _mm_fnmsub_ps(a, b, c); }
+#else
+            static type fmadd(type a, type b, type c) { return add(mul(a, b), c); }
+            static type fnmadd(type a, type b, type c) { return sub(c, mul(a, b)); }
+            static type fnmsub(type a, type b, type c) { return sub(sub(_mm_setzero_ps(), mul(a, b)), c); }
+#endif
+
+            static type zero_where_positive(type c, type x) {
+                return _mm_andnot_ps(_mm_cmpgt_ps(c, _mm_setzero_ps()), x);
+            }
+
+            using mask_type = int;
+            // SSE2 has no masked loads/stores, the mask is the lane count and they go through a buffer
+            static mask_type mask(int n) { return n < width ? n : width; }
+            static type maskz_loadu(mask_type m, const float *p) {
+                alignas(16) float tmp[width] = {};
+                for (int l = 0; l < m; ++l)
+                    tmp[l] = p[l];
+                return _mm_load_ps(tmp);
+            }
+            static void mask_storeu(float *p, mask_type m, type v) {
+                alignas(16) float tmp[width];
+                _mm_store_ps(tmp, v);
+                for (int l = 0; l < m; ++l)
+                    p[l] = tmp[l];
+            }
+        };
+
+        template <>
+        struct simd<double> {
+            using type = __m128d;
+            static constexpr int width = 2;
+
+            static type load(const double *p) { return _mm_load_pd(p); }
+            static void store(double *p, type v) { _mm_store_pd(p, v); }
+            static void stream(double *p, type v) { _mm_stream_pd(p, v); }
+            static type loadu(const double *p) { return _mm_loadu_pd(p); }
+            static void storeu(double *p, type v) { _mm_storeu_pd(p, v); }
+            static type set1(double x) { return _mm_set1_pd(x); }
+            static type add(type a, type b) { return _mm_add_pd(a, b); }
+            static type sub(type a, type b) { return _mm_sub_pd(a, b); }
+            static type mul(type a, type b) { return _mm_mul_pd(a, b); }
+            static type div(type a, type b) { return _mm_div_pd(a, b); }
+#if defined(__FMA__)
+            static type fmadd(type a, type b, type c) { return _mm_fmadd_pd(a, b, c); }
+            static type fnmadd(type a, type b, type c) { return _mm_fnmadd_pd(a, b, c); }
+            static type fnmsub(type a, type b, type c) { return _mm_fnmsub_pd(a, b, c); }
+#else
+            static type fmadd(type a, type b, type c) { return add(mul(a, b), c); }
+            static type fnmadd(type a, type b, type c) { return sub(c, mul(a, b)); }
+            static type fnmsub(type a, type b, type c) { return sub(sub(_mm_setzero_pd(), mul(a, b)), c); }
+#endif
+
+            static type zero_where_positive(type c, type x) {
+                return _mm_andnot_pd(_mm_cmpgt_pd(c, _mm_setzero_pd()), x);
+            }
+
+            using mask_type = int;
+            // SSE2 has no masked loads/stores, the mask is the lane count and they go through a buffer
+            static mask_type mask(int n) { return n < width ? n : width; }
+            static type maskz_loadu(mask_type m, const double *p) {
+                alignas(16) double tmp[width] = {};
+                for (int l = 0; l < m; ++l)
+                    tmp[l] = p[l];
+                return _mm_load_pd(tmp);
+            }
+            static void mask_storeu(double *p, mask_type m, type v) {
+                alignas(16) double tmp[width];
+                _mm_store_pd(tmp, v);
+                for (int l = 0; l < m; ++l)
+                    p[l] = tmp[l];
+            }
+        };
+#endif
+
+    } // namespace x86
+
+} // namespace platform
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <algorithm>
+
+#include "x86/x86_vadv_stencil_variant.h"
+
+namespace platform {
+
+    namespace x86 {
+
+        // advances the u, v and w systems in the same ij-blocked k-loop: the coefficients derived from wcon are
+        // computed once per (i, j, k) and, as they are the same for all three systems, so is ccol; each system
+        // keeps its own dcol, the backward sweep substitutes in place into it
+        template <class Platform, class ValueType>
+        class x86_vadv_variant_fused final : public x86_vadv_stencil_variant<Platform, ValueType> {
+          public:
+            using value_type = ValueType;
+            using platform = Platform;
+            using allocator = typename platform::template allocator<value_type>;
+
+            x86_vadv_variant_fused(const arguments_map &args)
+                : x86_vadv_stencil_variant<Platform, ValueType>(args, false),
+                  m_iblocksize(args.get<int>("i-blocksize")), m_jblocksize(args.get<int>("j-blocksize")),
+                  m_ccol(this->storage_size()), m_udcol(this->storage_size()), m_vdcol(this->storage_size()),
+                  m_wdcol(this->storage_size()) {
+                if (m_iblocksize <= 0 || m_jblocksize <= 0)
+                    throw ERROR("invalid block size");
+                if (this->istride() != 1)
+                    throw ERROR("this variant is only compatible with unit i-stride layout");
+            }
+            ~x86_vadv_variant_fused() {}
+
+            void vadv() override {
+                const int isize = this->isize();
+                const int jsize = this->jsize();
+
+#pragma omp parallel for collapse(2) schedule(static)
+                for (int jb = 0; jb < jsize; jb += m_jblocksize) {
+                    for (int ib = 0; ib < isize; ib += m_iblocksize) {
+                        const int imax = std::min(ib + m_iblocksize, isize);
+                        const int jmax = std::min(jb + m_jblocksize, jsize);
+                        forward_sweep(ib, imax, jb, jmax);
+                        backward_sweep(ib, imax, jb, jmax);
+                    }
+                }
+            }
+
+          private:
+            void forward_sweep(const int ib, const int imax, const int jb, const int jmax) {
+                constexpr value_type dtr_stage = 3.0 / 20.0;
+                constexpr value_type beta_v = 0;
+                constexpr value_type bet_m = 0.5 * (1.0 - beta_v);
+                constexpr value_type bet_p = 0.5 * (1.0 + beta_v);
+
+                const value_type *__restrict__ ustage = this->ustage();
+                const value_type *__restrict__ upos = this->upos();
+                const value_type *__restrict__ utens = this->utens();
+                const value_type *__restrict__ utensstage = this->utensstage();
+                const value_type *__restrict__ vstage = this->vstage();
+                const value_type *__restrict__ vpos = this->vpos();
+                const value_type *__restrict__ vtens = this->vtens();
+                const value_type *__restrict__ vtensstage = this->vtensstage();
+                const value_type *__restrict__ wstage = this->wstage();
+                const value_type *__restrict__ wpos = this->wpos();
+                const value_type *__restrict__ wtens = this->wtens();
+                const value_type *__restrict__ wtensstage = this->wtensstage();
+                value_type *__restrict__ ccol = m_ccol.data() + this->zero_offset();
+                value_type *__restrict__ udcol = m_udcol.data() + this->zero_offset();
+                value_type *__restrict__ vdcol = m_vdcol.data() + this->zero_offset();
+                value_type *__restrict__ wdcol = m_wdcol.data() + this->zero_offset();
+                const value_type *__restrict__ wcon = this->wcon();
+                const int ksize = this->ksize();
+                constexpr int istride = 1;
+                const int jstride = this->jstride();
+                const int kstride = this->kstride();
+                // wcon is averaged with its i-neighbour (ishift = 1, jshift = 0)
+                constexpr int shift = istride;
+
+                for (int k = 0; k < ksize; ++k) {
+                    for (int j = jb; j < jmax; ++j) {
+                        const int row = j * jstride + k * kstride;
+                        if (k == 0) {
+#pragma omp simd
+                            for (int i = ib; i < imax; ++i) {
+                                const int index = row + i * istride;
+                                value_type gcv =
+                                    value_type(0.25) * (wcon[index + shift + kstride] + wcon[index + kstride]);
+                                value_type cs = gcv * bet_m;
+
+                                value_type c = gcv * bet_p;
+                                value_type bcol = dtr_stage - c;
+
+                                value_type divided = value_type(1.0) / bcol;
+                                ccol[index] = c * divided;
+
+                                value_type ucorrection = -cs * (ustage[index + kstride] - ustage[index]);
+                                value_type ud =
+                                    dtr_stage * upos[index] + utens[index] + utensstage[index] + ucorrection;
+                                udcol[index] = ud * divided;
+
+                                value_type vcorrection = -cs * (vstage[index + kstride] - vstage[index]);
+                                value_type vd =
+                                    dtr_stage * vpos[index] + vtens[index] + vtensstage[index] + vcorrection;
+                                vdcol[index] = vd * divided;
+
+                                value_type wcorrection = -cs * (wstage[index + kstride] - wstage[index]);
+                                value_type wd =
+                                    dtr_stage * wpos[index] + wtens[index] + wtensstage[index] + wcorrection;
+                                wdcol[index] = wd * divided;
+                            }
+                        } else if (k < ksize - 1) {
+#pragma omp simd
+                            for (int i = ib; i < imax; ++i) {
+                                const int index = row + i * istride;
+                                value_type gav = value_type(-0.25) * (wcon[index + shift] + wcon[index]);
+                                value_type gcv =
+                                    value_type(0.25) * (wcon[index + shift + kstride] + wcon[index + kstride]);
+
+                                value_type as = gav * bet_m;
+                                value_type cs = gcv * bet_m;
+
+                                value_type acol = gav * bet_p;
+                                value_type c = gcv * bet_p;
+                                value_type bcol = dtr_stage - acol - c;
+
+                                value_type divided = value_type(1.0) / (bcol - ccol[index - kstride] * acol);
+                                ccol[index] = c * divided;
+
+                                value_type ucorrection = -as * (ustage[index - kstride] - ustage[index]) -
+                                                         cs * (ustage[index + kstride] - ustage[index]);
+                                value_type ud =
+                                    dtr_stage * upos[index] + utens[index] + utensstage[index] + ucorrection;
+                                udcol[index] = (ud - udcol[index - kstride] * acol) * divided;
+
+                                value_type vcorrection = -as * (vstage[index - kstride] - vstage[index]) -
+                                                         cs * (vstage[index + kstride] - vstage[index]);
+                                value_type vd =
+                                    dtr_stage * vpos[index] + vtens[index] + vtensstage[index] + vcorrection;
+                                vdcol[index] = (vd - vdcol[index - kstride] * acol) * divided;
+
+                                value_type wcorrection = -as * (wstage[index - kstride] - wstage[index]) -
+                                                         cs * (wstage[index + kstride] - wstage[index]);
+                                value_type wd =
+                                    dtr_stage * wpos[index] + wtens[index] + wtensstage[index] + wcorrection;
+                                wdcol[index] = (wd - wdcol[index - kstride] * acol) * divided;
+                            }
+                        } else {
+#pragma omp simd
+                            for (int i = ib; i < imax; ++i) {
+                                const int index = row + i * istride;
+                                value_type gav = value_type(-0.25) * (wcon[index + shift] + wcon[index]);
+
+                                value_type as = gav * bet_m;
+
+                                value_type acol = gav * bet_p;
+                                value_type bcol = dtr_stage - acol;
+
+                                value_type divided = value_type(1.0) / (bcol - ccol[index - kstride] * acol);
+
+                                value_type ucorrection = -as * (ustage[index - kstride] - ustage[index]);
+                                value_type ud =
+                                    dtr_stage * upos[index] + utens[index] + utensstage[index] + ucorrection;
+                                udcol[index] = (ud - udcol[index - kstride] * acol) * divided;
+
+                                value_type vcorrection = -as * (vstage[index - kstride] - vstage[index]);
+                                value_type vd =
+                                    dtr_stage * vpos[index] + vtens[index] + vtensstage[index] + vcorrection;
+                                vdcol[index] = (vd - vdcol[index - kstride] * acol) * divided;
+
+                                value_type wcorrection = -as * (wstage[index - kstride] - wstage[index]);
+                                value_type wd =
+                                    dtr_stage * wpos[index] + wtens[index] + wtensstage[index] + wcorrection;
+                                wdcol[index] = (wd - wdcol[index - kstride] * acol) * divided;
+                            }
+                        }
+                    }
+                }
+            }
+
+            void backward_sweep(const int ib, const int imax, const int jb, const int jmax) {
+                constexpr value_type dtr_stage = 3.0 / 20.0;
+
+                const value_type *__restrict__ upos = this->upos();
+                value_type *__restrict__ utensstage = this->utensstage();
+                const value_type *__restrict__ vpos = this->vpos();
+                value_type *__restrict__ vtensstage = this->vtensstage();
+                const value_type *__restrict__ wpos = this->wpos();
+                value_type *__restrict__ wtensstage = this->wtensstage();
+                const value_type *__restrict__ ccol = m_ccol.data() + this->zero_offset();
+                value_type *__restrict__ udcol = m_udcol.data() + this->zero_offset();
+                value_type *__restrict__ vdcol = m_vdcol.data() + this->zero_offset();
+                value_type *__restrict__ wdcol = m_wdcol.data() + this->zero_offset();
+                const int ksize = this->ksize();
+                constexpr int istride = 1;
+                const int jstride = this->jstride();
+                const int kstride = this->kstride();
+
+                // the solution overwrites dcol, on the last level dcol already is the solution
+                for (int k = ksize - 1; k >= 0; --k) {
+                    for (int j = jb; j < jmax; ++j) {
+                        const int row = j * jstride + k * kstride;
+                        if (k == ksize - 1) {
+#pragma omp simd
+                            for (int i = ib; i < imax; ++i) {
+                                const int index = row + i * istride;
+                                utensstage[index] = dtr_stage * (udcol[index] - upos[index]);
+                                vtensstage[index] = dtr_stage * (vdcol[index] - vpos[index]);
+                                wtensstage[index] = dtr_stage * (wdcol[index] - wpos[index]);
+                            }
+                        } else {
+#pragma omp simd
+                            for (int i = ib; i < imax; ++i) {
+                                const int index = row + i * istride;
+                                udcol[index] = udcol[index] - ccol[index] * udcol[index + kstride];
+                                utensstage[index] = dtr_stage * (udcol[index] - upos[index]);
+                                vdcol[index] = vdcol[index] - ccol[index] * vdcol[index + kstride];
+                                vtensstage[index] = dtr_stage * (vdcol[index] - vpos[index]);
+                                wdcol[index] = wdcol[index] - ccol[index] * wdcol[index + kstride];
+                                wtensstage[index] = dtr_stage * (wdcol[index] - wpos[index]);
+                            }
+                        }
+                    }
+                }
+            }
+
+            int m_iblocksize, m_jblocksize;
+            // ccol and one dcol per system, the base class does not allocate its intermediates (datacol is not used)
+            std::vector<value_type, allocator> m_ccol, m_udcol, m_vdcol, m_wdcol;
+        };
+
+    } // namespace x86
+
+} // namespace platform
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <algorithm>
+
+#include "x86/x86_vadv_stencil_variant.h"
+
+namespace platform {
+
+    namespace x86 {
+
+        // solves all columns of an ij-block together, k outermost and i innermost: the sweeps vectorize over
+        // columns and the block's part of ccol/dcol stays in cache between forward and backward sweep
+        template <class Platform, class ValueType>
+        class x86_vadv_variant_ij_blocked final : public x86_vadv_stencil_variant<Platform, ValueType> {
+          public:
+            using value_type = ValueType;
+
+            x86_vadv_variant_ij_blocked(const arguments_map &args)
+                : x86_vadv_stencil_variant<Platform, ValueType>(args), m_iblocksize(args.get<int>("i-blocksize")),
+                  m_jblocksize(args.get<int>("j-blocksize")) {
+                if (m_iblocksize <= 0 || m_jblocksize <= 0)
+                    throw ERROR("invalid block size");
+                if (this->istride() != 1)
+                    throw ERROR("this variant is only compatible with unit i-stride layout");
+            }
+            ~x86_vadv_variant_ij_blocked() {}
+
+            void vadv() override {
+                const int isize = this->isize();
+                const int jsize = this->jsize();
+
+#pragma omp parallel for collapse(2) schedule(static)
+                for (int jb = 0; jb < jsize; jb += m_jblocksize) {
+                    for (int ib = 0; ib < isize; ib += m_iblocksize) {
+                        const int imax = std::min(ib + m_iblocksize, isize);
+                        const int jmax = std::min(jb + m_jblocksize, jsize);
+
+                        solve_block(
+                            ib, imax, jb, jmax, this->ustage(), this->upos(), this->utens(), this->utensstage());
+                        solve_block(
+                            ib, imax, jb, jmax, this->vstage(), this->vpos(), this->vtens(), this->vtensstage());
+                        solve_block(
+                            ib, imax, jb, jmax, this->wstage(), this->wpos(), this->wtens(), this->wtensstage());
+                    }
+                }
+            }
+
+          private:
+            void solve_block(const int ib,
+                const int imax,
+                const int jb,
+                const int jmax,
+                const value_type *__restrict__ ustage,
+                const value_type *__restrict__ upos,
+                const value_type *__restrict__ utens,
+                value_type *__restrict__ utensstage) {
+                constexpr value_type dtr_stage = 3.0 / 20.0;
+                constexpr value_type beta_v = 0;
+                constexpr value_type bet_m = 0.5 * (1.0 - beta_v);
+                constexpr value_type bet_p = 0.5 * (1.0 + beta_v);
+
+                value_type *__restrict__ ccol = this->ccol();
+                value_type *__restrict__ dcol = this->dcol();
+                const value_type *__restrict__ wcon = this->wcon();
+                value_type *__restrict__ datacol = this->datacol();
+                const int ksize = this->ksize();
+                constexpr int istride = 1;
+                const int jstride = this->jstride();
+                const int kstride = this->kstride();
+                // wcon is averaged with its i-neighbour (ishift = 1, jshift = 0)
+                constexpr int shift = istride;
+
+                // forward sweep
+                for (int k = 0; k < ksize; ++k) {
+                    for (int j = jb; j < jmax; ++j) {
+                        const int row = j * jstride + k * kstride;
+                        if (k == 0) {
+#pragma omp simd
+                            for (int i = ib; i < imax; ++i) {
+                                const int index = row + i * istride;
+                                value_type gcv =
+                                    value_type(0.25) * (wcon[index + shift + kstride] + wcon[index + kstride]);
+                                value_type cs = gcv * bet_m;
+
+                                value_type c = gcv * bet_p;
+                                value_type bcol = dtr_stage - c;
+
+                                value_type correction_term = -cs * (ustage[index + kstride] - ustage[index]);
+                                value_type d =
+                                    dtr_stage * upos[index] + utens[index] + utensstage[index] + correction_term;
+
+                                value_type divided = value_type(1.0) / bcol;
+                                ccol[index] = c * divided;
+                                dcol[index] = d * divided;
+                            }
+                        } else if (k < ksize - 1) {
+#pragma omp simd
+                            for (int i = ib; i < imax; ++i) {
+                                const int index = row + i * istride;
+                                value_type gav = value_type(-0.25) * (wcon[index + shift] + wcon[index]);
+                                value_type gcv =
+                                    value_type(0.25) * (wcon[index + shift + kstride] + wcon[index + kstride]);
+
+                                value_type as = gav * bet_m;
+                                value_type cs = gcv * bet_m;
+
+                                value_type acol = gav * bet_p;
+                                value_type c = gcv * bet_p;
+                                value_type bcol = dtr_stage - acol - c;
+
+                                value_type correction_term = -as * (ustage[index - kstride] - ustage[index]) -
+                                                             cs * (ustage[index + kstride] - ustage[index]);
+                                value_type d =
+                                    dtr_stage * upos[index] + utens[index] + utensstage[index] + correction_term;
+
+                                value_type divided = value_type(1.0) / (bcol - ccol[index - kstride] * acol);
+                                ccol[index] = c * divided;
+                                dcol[index] = (d - dcol[index - kstride] * acol) * divided;
+                            }
+                        } else {
+#pragma omp simd
+                            for (int i = ib; i < imax; ++i) {
+                                const int index = row + i * istride;
+                                value_type gav = value_type(-0.25) * (wcon[index + shift] + wcon[index]);
+
+                                value_type as = gav * bet_m;
+
+                                value_type acol = gav * bet_p;
+                                value_type bcol = dtr_stage - acol;
+
+                                value_type correction_term = -as * (ustage[index - kstride] - ustage[index]);
+                                value_type d =
+                                    dtr_stage * upos[index] + utens[index] + utensstage[index] + correction_term;
+
+                                value_type divided = value_type(1.0) / (bcol - ccol[index - kstride] * acol);
+                                dcol[index] = (d - dcol[index - kstride] * acol) * divided;
+                            }
+                        }
+                    }
+                }
+
+                // backward sweep
+                for (int k = ksize - 1; k >= 0; --k) {
+                    for (int j = jb; j < jmax; ++j) {
+                        const int row = j * jstride + k * kstride;
+                        if (k == ksize - 1) {
+#pragma omp simd
+                            for (int i = ib; i < imax; ++i) {
+                                const int index = row + i * istride;
+                                datacol[index] = dcol[index];
+                                ccol[index] = datacol[index];
+                                utensstage[index] = dtr_stage * (datacol[index] - upos[index]);
+                            }
+                        } else {
+#pragma omp simd
+                            for (int i = ib; i < imax; ++i) {
+                                const int index = row + i * istride;
+                                datacol[index] = dcol[index] - ccol[index] * datacol[index + kstride];
+                                ccol[index] = datacol[index];
+                                utensstage[index] = dtr_stage * (datacol[index] - upos[index]);
+                            }
+                        }
+                    }
+                }
+            }
+
+            int m_iblocksize, m_jblocksize;
+        };
+
+    } // namespace x86
+
+} // namespace platform
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "x86/x86_vadv_stencil_variant.h"
+
+namespace platform {
+
+    namespace x86 {
+
+        // keeps ccol and dcol of an i-row of up to i-blocksize columns in a per-thread k x i-blocksize scratch
+        // buffer that stays in L1/L2, the backward sweep substitutes in place into dcol; the 3D ccol, dcol and
+        // datacol fields are not allocated at all
+        template <class Platform, class ValueType>
+        class x86_vadv_variant_local final : public x86_vadv_stencil_variant<Platform, ValueType> {
+          public:
+            using value_type = ValueType;
+
+            x86_vadv_variant_local(const arguments_map &args)
+                : x86_vadv_stencil_variant<Platform, ValueType>(args, false),
+                  m_iblocksize(args.get<int>("i-blocksize")) {
+                if (m_iblocksize <= 0)
+                    throw ERROR("invalid block size");
+                if (this->istride() != 1)
+                    throw ERROR("this variant is only compatible with unit i-stride layout");
+            }
+            ~x86_vadv_variant_local() {}
+
+            void vadv() override {
+                const int isize = this->isize();
+                const int jsize = this->jsize();
+                const int ksize = this->ksize();
+
+#pragma omp parallel
+                {
+                    std::vector<value_type> ccol(ksize * m_iblocksize), dcol(ksize * m_iblocksize);
+
+#pragma omp for collapse(2) schedule(static)
+                    for (int j = 0; j < jsize; ++j) {
+                        for (int ib = 0; ib < isize; ib += m_iblocksize) {
+                            const int imax = std::min(ib + m_iblocksize, isize);
+                            solve_row(ib,
+                                imax,
+                                j,
+                                ccol.data(),
+                                dcol.data(),
+                                this->ustage(),
+                                this->upos(),
+                                this->utens(),
+                                this->utensstage());
+                            solve_row(ib,
+                                imax,
+                                j,
+                                ccol.data(),
+                                dcol.data(),
+                                this->vstage(),
+                                this->vpos(),
+                                this->vtens(),
+                                this->vtensstage());
+                            solve_row(ib,
+                                imax,
+                                j,
+                                ccol.data(),
+                                dcol.data(),
+                                this->wstage(),
+                                this->wpos(),
+                                this->wtens(),
+                                this->wtensstage());
+                        }
+                    }
+                }
+            }
+
+          private:
+            // solves the columns [ib, imax) x {j}, scratch element (i, k) is at (i - ib) + k * i-blocksize
+            void solve_row(const int ib,
+                const int imax,
+                const int j,
+                value_type *__restrict__ ccol,
+                value_type *__restrict__ dcol,
+                const value_type *__restrict__ ustage,
+                const value_type *__restrict__ upos,
+                const value_type *__restrict__ utens,
+                value_type *__restrict__ utensstage) {
+                constexpr value_type dtr_stage = 3.0 / 20.0;
+                constexpr value_type beta_v = 0;
+                constexpr value_type bet_m = 0.5 * (1.0 - beta_v);
+                constexpr value_type bet_p = 0.5 * (1.0 + beta_v);
+
+                const value_type *__restrict__ wcon = this->wcon();
+                const int ksize = this->ksize();
+                constexpr int istride = 1;
+                const int jstride = this->jstride();
+                const int kstride = this->kstride();
+                const int n = imax - ib;
+                const int s = m_iblocksize;
+                // wcon is averaged with its i-neighbour (ishift = 1, jshift = 0)
+                constexpr int shift = istride;
+
+                // forward sweep
+                for (int k = 0; k < ksize; ++k) {
+                    const int row = ib * istride + j * jstride + k * kstride;
+                    value_type *__restrict__ c_k = ccol + k * s;
+                    value_type *__restrict__ d_k = dcol + k * s;
+                    if (k == 0) {
+#pragma omp simd
+                        for (int l = 0; l < n; ++l) {
+                            const int index = row + l * istride;
+                            value_type gcv =
+                                value_type(0.25) * (wcon[index + shift + kstride] + wcon[index + kstride]);
+                            value_type cs = gcv * bet_m;
+
+                            value_type c = gcv * bet_p;
+                            value_type bcol = dtr_stage - c;
+
+                            value_type correction_term = -cs * (ustage[index + kstride] - ustage[index]);
+                            value_type d = dtr_stage * upos[index] + utens[index] + utensstage[index] + correction_term;
+
+                            value_type divided = value_type(1.0) / bcol;
+                            c_k[l] = c * divided;
+                            d_k[l] = d * divided;
+                        }
+                    } else if (k < ksize - 1) {
+                        const value_type *__restrict__ c_km1 = ccol + (k - 1) * s;
+                        const value_type *__restrict__ d_km1 = dcol + (k - 1) * s;
+#pragma omp simd
+                        for (int l = 0; l < n; ++l) {
+                            const int index = row + l * istride;
+                            value_type gav = value_type(-0.25) * (wcon[index + shift] + wcon[index]);
+                            value_type gcv =
+                                value_type(0.25) * (wcon[index + shift + kstride] + wcon[index + kstride]);
+
+                            value_type as = gav * bet_m;
+                            value_type cs = gcv * bet_m;
+
+                            value_type acol = gav * bet_p;
+                            value_type c = gcv * bet_p;
+                            value_type bcol = dtr_stage - acol - c;
+
+                            value_type correction_term = -as * (ustage[index - kstride] - ustage[index]) -
+                                                         cs * (ustage[index + kstride] - ustage[index]);
+                            value_type d = dtr_stage * upos[index] + utens[index] + utensstage[index] + correction_term;
+
+                            value_type divided = value_type(1.0) / (bcol - c_km1[l] * acol);
+                            c_k[l] = c * divided;
+                            d_k[l] = (d - d_km1[l] * acol) * divided;
+                        }
+                    } else {
+                        const value_type *__restrict__ c_km1 = ccol + (k - 1) * s;
+                        const value_type *__restrict__ d_km1 = dcol + (k - 1) * s;
+#pragma omp simd
+                        for (int l = 0; l < n; ++l) {
+                            const int index = row + l * istride;
+                            value_type gav = value_type(-0.25) * (wcon[index + shift] + wcon[index]);
+
+                            value_type as = gav * bet_m;
+
+                            value_type acol = gav * bet_p;
+                            value_type bcol = dtr_stage - acol;
+
+                            value_type correction_term = -as * (ustage[index - kstride] - ustage[index]);
+                            value_type d = dtr_stage * upos[index] + utens[index] + utensstage[index] + correction_term;
+
+                            value_type divided = value_type(1.0) / (bcol - c_km1[l] * acol);
+                            d_k[l] = (d - d_km1[l] * acol) * divided;
+                        }
+                    }
+                }
+
+                // backward sweep, the solution overwrites dcol, on the last level dcol already is the solution
+                for (int k = ksize - 1; k >= 0; --k) {
+                    const int row = ib * istride + j * jstride + k * kstride;
+                    const value_type *__restrict__ c_k = ccol + k * s;
+                    value_type *__restrict__ d_k = dcol + k * s;
+                    const value_type *__restrict__ d_kp1 = dcol + (k + 1) * s;
+                    if (k == ksize - 1) {
+#pragma omp simd
+                        for (int l = 0; l < n; ++l)
+                            utensstage[row + l] = dtr_stage * (d_k[l] - upos[row + l]);
+                    } else {
+#pragma omp simd
+                        for (int l = 0; l < n; ++l) {
+                            d_k[l] = d_k[l] - c_k[l] * d_kp1[l];
+                            utensstage[row + l] = dtr_stage * (d_k[l] - upos[row + l]);
+                        }
+                    }
+                }
+            }
+
+            int m_iblocksize;
+        };
+
+    } // namespace x86
+
+} // namespace platform
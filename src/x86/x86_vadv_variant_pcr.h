@@ -0,0 +1,235 @@
+#pragma once
+
+#include <algorithm>
+#include <omp.h>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "x86/x86_vadv_stencil_variant.h"
+
+namespace platform {
+
+    namespace x86 {
+
+        // solves the vadv systems with parallel cyclic reduction (PCR) along k, a PCR/Thomas hybrid or plain
+        // Thomas; each PCR step doubles the coupling distance s, after p steps the system of each column splits
+        // into 2^p independent interleaved subsystems, so k adds parallelism when there are too few columns;
+        // 'auto' uses Thomas if there are at least columns-per-thread columns per thread and just enough PCR
+        // steps to reach that otherwise
+        template <class Platform, class ValueType>
+        class x86_vadv_variant_pcr final : public x86_vadv_stencil_variant<Platform, ValueType> {
+          public:
+            using value_type = ValueType;
+            using platform = Platform;
+            using allocator = typename platform::template allocator<value_type>;
+
+            x86_vadv_variant_pcr(const arguments_map &args)
+                : x86_vadv_stencil_variant<Platform, ValueType>(args, false),
+                  m_size(this->isize() * this->jsize() * this->ksize()), m_a(2 * m_size), m_b(2 * m_size),
+                  m_c(2 * m_size), m_d(2 * m_size) {
+                const std::string solver = args.get("solver");
+                const int ksize = this->ksize();
+                int full_steps = 0;
+                while ((1 << full_steps) < ksize)
+                    ++full_steps;
+
+                if (solver == "thomas") {
+                    m_steps = 0;
+                } else if (solver == "pcr") {
+                    m_steps = full_steps;
+                } else if (solver == "hybrid") {
+                    m_steps = args.get<int>("pcr-steps");
+                    if (m_steps < 0)
+                        throw ERROR("invalid number of PCR steps");
+                    m_steps = std::min(m_steps, full_steps);
+                } else if (solver == "auto") {
+                    const int columns_per_thread = args.get<int>("columns-per-thread");
+                    if (columns_per_thread <= 0)
+                        throw ERROR("invalid number of columns per thread");
+                    const long wanted = long(columns_per_thread) * omp_get_max_threads();
+                    const long columns = long(this->isize()) * this->jsize();
+                    m_steps = 0;
+                    while (m_steps < full_steps && (columns << m_steps) < wanted)
+                        ++m_steps;
+                } else {
+                    throw ERROR("invalid solver '" + solver + "'");
+                }
+
+                // the random test systems are not diagonally dominant, in single precision the rounding
+                // differences between PCR and the Thomas reference exceed the verify tolerance
+                if (m_steps > 0 && std::is_same<value_type, float>::value) {
+                    if (solver == "auto")
+                        m_steps = 0;
+                    else
+                        throw ERROR("the pcr and hybrid solvers require double precision");
+                }
+            }
+            ~x86_vadv_variant_pcr() {}
+
+            void vadv() override {
+                solve(this->ustage(), this->upos(), this->utens(), this->utensstage());
+                solve(this->vstage(), this->vpos(), this->vtens(), this->vtensstage());
+                solve(this->wstage(), this->wpos(), this->wtens(), this->wtensstage());
+            }
+
+          private:
+            void solve(const value_type *__restrict__ ustage,
+                const value_type *__restrict__ upos,
+                const value_type *__restrict__ utens,
+                value_type *__restrict__ utensstage) {
+                constexpr value_type dtr_stage = 3.0 / 20.0;
+                constexpr value_type beta_v = 0;
+                constexpr value_type bet_m = 0.5 * (1.0 - beta_v);
+                constexpr value_type bet_p = 0.5 * (1.0 + beta_v);
+
+                const value_type *__restrict__ wcon = this->wcon();
+                const int isize = this->isize();
+                const int jsize = this->jsize();
+                const int ksize = this->ksize();
+                const int istride = this->istride();
+                const int jstride = this->jstride();
+                const int kstride = this->kstride();
+                // wcon is averaged with its i-neighbour (ishift = 1, jshift = 0)
+                const int shift = istride;
+                // coefficients are stored compactly, i fastest, k slowest
+                const int cj = isize;
+                const int ck = isize * jsize;
+                const int steps = m_steps;
+                const int subsystems = 1 << steps;
+
+#pragma omp parallel
+                {
+                    value_type *__restrict__ a = m_a.data();
+                    value_type *__restrict__ b = m_b.data();
+                    value_type *__restrict__ c = m_c.data();
+                    value_type *__restrict__ d = m_d.data();
+
+                    // system k: a * x[k - 1] + b * x[k] + c * x[k + 1] = d
+#pragma omp for collapse(2)
+                    for (int k = 0; k < ksize; ++k) {
+                        for (int j = 0; j < jsize; ++j) {
+                            const bool lo = k > 0, hi = k < ksize - 1;
+                            const int km = lo ? kstride : 0, kp = hi ? kstride : 0;
+#pragma omp simd
+                            for (int i = 0; i < isize; ++i) {
+                                const int index = i * istride + j * jstride + k * kstride;
+                                const int cindex = i + j * cj + k * ck;
+                                value_type gav = lo ? value_type(-0.25) * (wcon[index + shift] + wcon[index]) : 0;
+                                value_type gcv =
+                                    hi ? value_type(0.25) * (wcon[index + shift + kstride] + wcon[index + kstride])
+                                       : 0;
+
+                                value_type as = gav * bet_m;
+                                value_type cs = gcv * bet_m;
+
+                                value_type acol = gav * bet_p;
+                                value_type ccol = gcv * bet_p;
+
+                                value_type correction_term = -as * (ustage[index - km] - ustage[index]) -
+                                                             cs * (ustage[index + kp] - ustage[index]);
+                                a[cindex] = acol;
+                                b[cindex] = dtr_stage - acol - ccol;
+                                c[cindex] = ccol;
+                                d[cindex] = dtr_stage * upos[index] + utens[index] + utensstage[index] + correction_term;
+                            }
+                        }
+                    }
+
+                    // PCR steps, eliminating the couplings to k - s and k + s doubles the coupling distance
+                    for (int step = 0; step < steps; ++step) {
+                        const int s = 1 << step;
+                        value_type *__restrict__ a2 = a == m_a.data() ? a + m_size : m_a.data();
+                        value_type *__restrict__ b2 = b == m_b.data() ? b + m_size : m_b.data();
+                        value_type *__restrict__ c2 = c == m_c.data() ? c + m_size : m_c.data();
+                        value_type *__restrict__ d2 = d == m_d.data() ? d + m_size : m_d.data();
+#pragma omp for collapse(2)
+                        for (int k = 0; k < ksize; ++k) {
+                            for (int j = 0; j < jsize; ++j) {
+                                const bool lo = k - s >= 0, hi = k + s < ksize;
+                                const int row = j * cj + k * ck;
+                                const int rowm = j * cj + (lo ? k - s : k) * ck;
+                                const int rowp = j * cj + (hi ? k + s : k) * ck;
+#pragma omp simd
+                                for (int i = 0; i < isize; ++i) {
+                                    const value_type alpha = lo ? -a[row + i] / b[rowm + i] : 0;
+                                    const value_type gamma = hi ? -c[row + i] / b[rowp + i] : 0;
+                                    a2[row + i] = alpha * a[rowm + i];
+                                    b2[row + i] = b[row + i] + alpha * c[rowm + i] + gamma * a[rowp + i];
+                                    c2[row + i] = gamma * c[rowp + i];
+                                    d2[row + i] = d[row + i] + alpha * d[rowm + i] + gamma * d[rowp + i];
+                                }
+                            }
+                        }
+                        a = a2;
+                        b = b2;
+                        c = c2;
+                        d = d2;
+                    }
+
+                    if (subsystems >= ksize) {
+                        // fully reduced, every equation is decoupled
+#pragma omp for collapse(2)
+                        for (int k = 0; k < ksize; ++k) {
+                            for (int j = 0; j < jsize; ++j) {
+#pragma omp simd
+                                for (int i = 0; i < isize; ++i) {
+                                    const int index = i * istride + j * jstride + k * kstride;
+                                    const int cindex = i + j * cj + k * ck;
+                                    utensstage[index] = dtr_stage * (d[cindex] / b[cindex] - upos[index]);
+                                }
+                            }
+                        }
+                    } else {
+                        // Thomas on the subsystems {r, r + S, r + 2S, ...}, the solution overwrites d
+#pragma omp for collapse(2)
+                        for (int r = 0; r < subsystems; ++r) {
+                            for (int j = 0; j < jsize; ++j) {
+                                const int stride = subsystems * ck;
+#pragma omp simd
+                                for (int i = 0; i < isize; ++i) {
+                                    const int cindex = i + j * cj + r * ck;
+                                    value_type divided = value_type(1.0) / b[cindex];
+                                    c[cindex] = c[cindex] * divided;
+                                    d[cindex] = d[cindex] * divided;
+                                }
+                                for (int k = r + subsystems; k < ksize; k += subsystems) {
+#pragma omp simd
+                                    for (int i = 0; i < isize; ++i) {
+                                        const int cindex = i + j * cj + k * ck;
+                                        value_type divided =
+                                            value_type(1.0) / (b[cindex] - c[cindex - stride] * a[cindex]);
+                                        c[cindex] = c[cindex] * divided;
+                                        d[cindex] = (d[cindex] - d[cindex - stride] * a[cindex]) * divided;
+                                    }
+                                }
+
+                                int k = r + (ksize - 1 - r) / subsystems * subsystems;
+#pragma omp simd
+                                for (int i = 0; i < isize; ++i) {
+                                    const int index = i * istride + j * jstride + k * kstride;
+                                    const int cindex = i + j * cj + k * ck;
+                                    utensstage[index] = dtr_stage * (d[cindex] - upos[index]);
+                                }
+                                for (k -= subsystems; k >= 0; k -= subsystems) {
+#pragma omp simd
+                                    for (int i = 0; i < isize; ++i) {
+                                        const int index = i * istride + j * jstride + k * kstride;
+                                        const int cindex = i + j * cj + k * ck;
+                                        d[cindex] = d[cindex] - c[cindex] * d[cindex + stride];
+                                        utensstage[index] = dtr_stage * (d[cindex] - upos[index]);
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            int m_size, m_steps;
+            std::vector<value_type, allocator> m_a, m_b, m_c, m_d;
+        };
+
+    } // namespace x86
+
+} // namespace platform
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "x86/x86_simd.h"
+#include "x86/x86_vadv_stencil_variant.h"
+
+namespace platform {
+
+    namespace x86 {
+
+        // solves simd<ValueType>::width adjacent i-columns in the vector lanes, the k recurrences stay serial but
+        // every division now serves a full vector of columns; the i-remainder of each row uses masked loads/stores
+        template <class Platform, class ValueType>
+        class x86_vadv_variant_simd final : public x86_vadv_stencil_variant<Platform, ValueType> {
+          public:
+            using value_type = ValueType;
+            using vec = simd<value_type>;
+            using vtype = typename vec::type;
+            using mask_type = typename vec::mask_type;
+
+            x86_vadv_variant_simd(const arguments_map &args) : x86_vadv_stencil_variant<Platform, ValueType>(args) {
+                if (this->istride() != 1)
+                    throw ERROR("this variant is only compatible with unit i-stride layout");
+            }
+            ~x86_vadv_variant_simd() {}
+
+            void vadv() override {
+                constexpr int width = vec::width;
+                const int isize = this->isize();
+                const int jsize = this->jsize();
+
+#pragma omp parallel for collapse(2)
+                for (int j = 0; j < jsize; ++j) {
+                    for (int i = 0; i < isize; i += width) {
+                        if (i + width <= isize) {
+                            solve_columns<false>(i, j, mask_type(), this->ustage(), this->upos(), this->utens(),
+                                this->utensstage());
+                            solve_columns<false>(i, j, mask_type(), this->vstage(), this->vpos(), this->vtens(),
+                                this->vtensstage());
+                            solve_columns<false>(i, j, mask_type(), this->wstage(), this->wpos(), this->wtens(),
+                                this->wtensstage());
+                        } else {
+                            const mask_type mask = vec::mask(isize - i);
+                            solve_columns<true>(
+                                i, j, mask, this->ustage(), this->upos(), this->utens(), this->utensstage());
+                            solve_columns<true>(
+                                i, j, mask, this->vstage(), this->vpos(), this->vtens(), this->vtensstage());
+                            solve_columns<true>(
+                                i, j, mask, this->wstage(), this->wpos(), this->wtens(), this->wtensstage());
+                        }
+                    }
+                }
+            }
+
+          private:
+            template <bool Masked>
+            static vtype load(mask_type mask, const value_type *p) {
+                return Masked ? vec::maskz_loadu(mask, p) : vec::loadu(p);
+            }
+
+            template <bool Masked>
+            static void store(mask_type mask, value_type *p, vtype v) {
+                if (Masked)
+                    vec::mask_storeu(p, mask, v);
+                else
+                    vec::storeu(p, v);
+            }
+
+            // forward and backward sweep of the columns [i, i + width) x {j}, the previous level's ccol/dcol
+            // and datacol are carried in registers; products are fused where contracted scalar code fuses them,
+            // the Thomas recurrence amplifies rounding differences beyond the single precision verify tolerance
+            template <bool Masked>
+            void solve_columns(const int i,
+                const int j,
+                const mask_type mask,
+                const value_type *__restrict__ ustage,
+                const value_type *__restrict__ upos,
+                const value_type *__restrict__ utens,
+                value_type *__restrict__ utensstage) {
+                const vtype dtr_stage = vec::set1(3.0 / 20.0);
+                constexpr value_type beta_v = 0;
+                const vtype bet_m = vec::set1(0.5 * (1.0 - beta_v));
+                const vtype bet_p = vec::set1(0.5 * (1.0 + beta_v));
+                const vtype one = vec::set1(1.0);
+                const vtype quarter = vec::set1(0.25);
+                const vtype minus_quarter = vec::set1(-0.25);
+
+                value_type *__restrict__ ccol = this->ccol();
+                value_type *__restrict__ dcol = this->dcol();
+                const value_type *__restrict__ wcon = this->wcon();
+                value_type *__restrict__ datacol = this->datacol();
+                const int ksize = this->ksize();
+                const int kstride = this->kstride();
+                // wcon is averaged with its i-neighbour (ishift = 1, jshift = 0)
+                constexpr int shift = 1;
+
+                auto ld = [mask](const value_type *p) { return load<Masked>(mask, p); };
+                auto st = [mask](value_type *p, vtype v) { store<Masked>(mask, p, v); };
+
+                vtype cprev, dprev;
+
+                // k minimum
+                {
+                    const int index = i + j * this->jstride();
+                    vtype gcv =
+                        vec::mul(quarter, vec::add(ld(&wcon[index + shift + kstride]), ld(&wcon[index + kstride])));
+                    vtype cs = vec::mul(gcv, bet_m);
+
+                    vtype c = vec::mul(gcv, bet_p);
+                    vtype bcol = vec::sub(dtr_stage, c);
+
+                    vtype d =
+                        vec::add(vec::fmadd(dtr_stage, ld(&upos[index]), ld(&utens[index])), ld(&utensstage[index]));
+                    d = vec::fnmadd(cs, vec::sub(ld(&ustage[index + kstride]), ld(&ustage[index])), d);
+
+                    vtype divided = vec::div(one, bcol);
+                    cprev = vec::mul(c, divided);
+                    dprev = vec::mul(d, divided);
+                    st(&ccol[index], cprev);
+                    st(&dcol[index], dprev);
+                }
+
+                // k body
+                for (int k = 1; k < ksize - 1; ++k) {
+                    const int index = i + j * this->jstride() + k * kstride;
+                    vtype gav = vec::mul(minus_quarter, vec::add(ld(&wcon[index + shift]), ld(&wcon[index])));
+                    vtype gcv =
+                        vec::mul(quarter, vec::add(ld(&wcon[index + shift + kstride]), ld(&wcon[index + kstride])));
+
+                    vtype as = vec::mul(gav, bet_m);
+                    vtype cs = vec::mul(gcv, bet_m);
+
+                    vtype acol = vec::mul(gav, bet_p);
+                    vtype c = vec::mul(gcv, bet_p);
+                    vtype bcol = vec::sub(vec::sub(dtr_stage, acol), c);
+
+                    vtype u = ld(&ustage[index]);
+                    vtype correction_term = vec::fnmsub(as,
+                        vec::sub(ld(&ustage[index - kstride]), u),
+                        vec::mul(cs, vec::sub(ld(&ustage[index + kstride]), u)));
+                    vtype d = vec::add(
+                        vec::add(vec::fmadd(dtr_stage, ld(&upos[index]), ld(&utens[index])), ld(&utensstage[index])),
+                        correction_term);
+
+                    vtype divided = vec::div(one, vec::fnmadd(cprev, acol, bcol));
+                    cprev = vec::mul(c, divided);
+                    dprev = vec::mul(vec::fnmadd(dprev, acol, d), divided);
+                    st(&ccol[index], cprev);
+                    st(&dcol[index], dprev);
+                }
+
+                // k maximum
+                {
+                    const int index = i + j * this->jstride() + (ksize - 1) * kstride;
+                    vtype gav = vec::mul(minus_quarter, vec::add(ld(&wcon[index + shift]), ld(&wcon[index])));
+
+                    vtype as = vec::mul(gav, bet_m);
+
+                    vtype acol = vec::mul(gav, bet_p);
+                    vtype bcol = vec::sub(dtr_stage, acol);
+
+                    vtype d =
+                        vec::add(vec::fmadd(dtr_stage, ld(&upos[index]), ld(&utens[index])), ld(&utensstage[index]));
+                    d = vec::fnmadd(as, vec::sub(ld(&ustage[index - kstride]), ld(&ustage[index])), d);
+
+                    vtype divided = vec::div(one, vec::fnmadd(cprev, acol, bcol));
+                    dprev = vec::mul(vec::fnmadd(dprev, acol, d), divided);
+                    st(&dcol[index], dprev);
+                }
+
+                // backward sweep
+                vtype data = dprev;
+                for (int k = ksize - 1; k >= 0; --k) {
+                    const int index = i + j * this->jstride() + k * kstride;
+                    if (k < ksize - 1)
+                        data = vec::fnmadd(ld(&ccol[index]), data, ld(&dcol[index]));
+                    st(&datacol[index], data);
+                    st(&ccol[index], data);
+                    st(&utensstage[index], vec::mul(dtr_stage, vec::sub(data, ld(&upos[index]))));
+                }
+            }
+        };
+
+    } // namespace x86
+
+} // namespace platform
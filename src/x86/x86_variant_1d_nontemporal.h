@@ -0,0 +1,46 @@
+#pragma once
+
+#include "x86/x86_basic_stencil_variant.h"
+#include "x86/x86_nontemporal.h"
+
+namespace platform {
+
+    namespace x86 {
+
+        template <class Platform, class ValueType>
+        class variant_1d_nontemporal final : public x86_basic_stencil_variant<Platform, ValueType> {
+          public:
+            using value_type = ValueType;
+
+            variant_1d_nontemporal(const arguments_map &args)
+                : x86_basic_stencil_variant<Platform, ValueType>(args),
+                  m_policy(parse_store_policy(args.get("store"),
+                      2 * this->storage_size() * sizeof(value_type),
+                      Platform::llc_size())) {}
+
+            template <class Stencil>
+            void kernel() {
+                const int last = this->index(this->isize() - 1, this->jsize() - 1, this->ksize() - 1);
+                const value_type *__restrict__ src = this->src();
+                const int istride = this->istride();
+                const int jstride = this->jstride();
+                const int kstride = this->kstride();
+                auto stencil = [=](int i) { return Stencil::eval(src + i, istride, jstride, kstride); };
+                if (m_policy == store_policy::nontemporal)
+                    parallel_store_range<true>(this->dst(), 0, last + 1, stencil);
+                else
+                    parallel_store_range<false>(this->dst(), 0, last + 1, stencil);
+            }
+
+          protected:
+            std::function<void()> stencil_function(const std::string &stencil) override {
+                return this->kernel_function(this, stencil, "x86/x86_variant_1d_nontemporal.h");
+            }
+
+          private:
+            store_policy m_policy;
+        };
+
+    } // namespace x86
+
+} // namespace platform
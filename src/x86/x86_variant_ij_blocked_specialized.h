@@ -0,0 +1,166 @@
+#pragma once
+
+#include <sstream>
+
+#include "x86/x86_basic_stencil_variant.h"
+
+namespace platform {
+
+    namespace x86 {
+
+        // domain sizes, strides and block sizes of variant_ij_blocked_specialized as runtime values
+        struct ij_blocked_runtime_sizes {
+            ij_blocked_runtime_sizes(int isize, int jsize, int ksize, int jstride, int kstride, int ibs, int jbs)
+                : isize(isize), jsize(jsize), ksize(ksize), jstride(jstride), kstride(kstride), iblocksize(ibs),
+                  jblocksize(jbs) {}
+
+            const int isize, jsize, ksize, jstride, kstride, iblocksize, jblocksize;
+        };
+
+        // the same values as compile-time constants, the constructor checks that they match the runtime values
+        template <int ISize, int JSize, int KSize, int JStride, int KStride, int IBlockSize, int JBlockSize>
+        struct ij_blocked_static_sizes {
+            ij_blocked_static_sizes(int isize, int jsize, int ksize, int jstride, int kstride, int ibs, int jbs) {
+                if (!matches(isize, jsize, ksize, jstride, kstride, ibs, jbs))
+                    throw ERROR("specialized kernel does not match domain and block sizes");
+            }
+
+            static bool matches(int isize, int jsize, int ksize, int jstride, int kstride, int ibs, int jbs) {
+                return isize == ISize && jsize == JSize && ksize == KSize && jstride == JStride &&
+                       kstride == KStride && ibs == IBlockSize && jbs == JBlockSize;
+            }
+
+            static constexpr int isize = ISize, jsize = JSize, ksize = KSize;
+            static constexpr int jstride = JStride, kstride = KStride;
+            static constexpr int iblocksize = IBlockSize, jblocksize = JBlockSize;
+        };
+
+        template <class... Sizes>
+        struct ij_blocked_presets {};
+
+        // specializations compiled into the binary: default domain (halo 2, alignment 1, i-first layout) with the
+        // default and with full-row i-blocks
+        using ij_blocked_default_presets =
+            ij_blocked_presets<ij_blocked_static_sizes<1024, 1024, 80, 1028, 1056784, 32, 8>,
+                ij_blocked_static_sizes<1024, 1024, 80, 1028, 1056784, 1024, 8>>;
+
+        // ij-blocked kernel with domain sizes, strides and block sizes as template parameters, so the compiler can
+        // fold all index computations and knows all trip counts; --specialize selects where the specialization
+        // comes from: "none" (runtime values, same loop nest), "preset" (compiled in) or "jit" (generated)
+        template <class Platform, class ValueType>
+        class variant_ij_blocked_specialized final : public x86_basic_stencil_variant<Platform, ValueType> {
+          public:
+            using value_type = ValueType;
+
+            variant_ij_blocked_specialized(const arguments_map &args)
+                : x86_basic_stencil_variant<Platform, ValueType>(args), m_iblocksize(args.get<int>("i-blocksize")),
+                  m_jblocksize(args.get<int>("j-blocksize")), m_specialize(args.get("specialize")) {
+                if (m_iblocksize <= 0 || m_jblocksize <= 0)
+                    throw ERROR("invalid block size");
+                if (m_specialize != "none" && m_specialize != "preset" && m_specialize != "jit")
+                    throw ERROR("invalid specialize value '" + m_specialize + "'");
+                if (this->istride() != 1)
+                    throw ERROR("this variant is only compatible with unit i-stride layout");
+            }
+
+            template <class Stencil, class Sizes = ij_blocked_runtime_sizes>
+            void kernel() {
+                const value_type *__restrict__ src = this->src();
+                value_type *__restrict__ dst = this->dst();
+                const Sizes sizes(this->isize(),
+                    this->jsize(),
+                    this->ksize(),
+                    this->jstride(),
+                    this->kstride(),
+                    m_iblocksize,
+                    m_jblocksize);
+                const int isize = sizes.isize;
+                const int jsize = sizes.jsize;
+                const int ksize = sizes.ksize;
+                constexpr int istride = 1;
+                const int jstride = sizes.jstride;
+                const int kstride = sizes.kstride;
+                const int iblocksize = sizes.iblocksize;
+                const int jblocksize = sizes.jblocksize;
+
+#pragma omp parallel for collapse(2) schedule(static)
+                for (int jb = 0; jb < jsize; jb += jblocksize) {
+                    for (int ib = 0; ib < isize; ib += iblocksize) {
+                        // the divisibility tests are constant for static sizes and remove the remainder handling
+                        const int imax =
+                            isize % iblocksize == 0 || ib + iblocksize <= isize ? ib + iblocksize : isize;
+                        const int jmax =
+                            jsize % jblocksize == 0 || jb + jblocksize <= jsize ? jb + jblocksize : jsize;
+
+                        for (int k = 0; k < ksize; ++k) {
+                            for (int j = jb; j < jmax; ++j) {
+                                const int row = j * jstride + k * kstride;
+#pragma omp simd
+                                for (int i = ib; i < imax; ++i) {
+                                    const int index = row + i * istride;
+                                    dst[index] = Stencil::eval(src + index, istride, jstride, kstride);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+          protected:
+            std::function<void()> stencil_function(const std::string &stencil) override {
+                const std::string header = "x86/x86_variant_ij_blocked_specialized.h";
+                if (m_specialize == "none")
+                    return this->kernel_function(this, stencil, header);
+                if (m_specialize == "preset" && stencil != "expr") {
+                    preset_binder binder{this, nullptr};
+                    basic_stencil::dispatch(basic_stencil::stencils(), stencil, binder);
+                    if (!binder.function)
+                        throw ERROR("no preset matches domain and block sizes, use --specialize jit");
+                    return binder.function;
+                }
+                // generated on demand, also in preset mode for user-defined stencils as these are only known at runtime
+                std::stringstream sizes;
+                sizes << ", platform::x86::ij_blocked_static_sizes<" << this->isize() << ", " << this->jsize() << ", "
+                      << this->ksize() << ", " << this->jstride() << ", " << this->kstride() << ", " << m_iblocksize
+                      << ", " << m_jblocksize << ">";
+                return this->jit_kernel_function(this, stencil, header, sizes.str());
+            }
+
+          private:
+            // functor for basic_stencil::dispatch, binds the kernel of the first matching preset
+            struct preset_binder {
+                template <class Stencil>
+                void apply() {
+                    function = bind<Stencil>(ij_blocked_default_presets());
+                }
+
+                template <class Stencil>
+                std::function<void()> bind(ij_blocked_presets<>) {
+                    return nullptr;
+                }
+
+                template <class Stencil, class Sizes, class... Rest>
+                std::function<void()> bind(ij_blocked_presets<Sizes, Rest...>) {
+                    if (!Sizes::matches(v->isize(),
+                            v->jsize(),
+                            v->ksize(),
+                            v->jstride(),
+                            v->kstride(),
+                            v->m_iblocksize,
+                            v->m_jblocksize))
+                        return bind<Stencil>(ij_blocked_presets<Rest...>());
+                    variant_ij_blocked_specialized *variant = v;
+                    return [variant]() { variant->template kernel<Stencil, Sizes>(); };
+                }
+
+                variant_ij_blocked_specialized *v;
+                std::function<void()> function;
+            };
+
+            int m_iblocksize, m_jblocksize;
+            std::string m_specialize;
+        };
+
+    } // namespace x86
+
+} // namespace platform
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "x86/x86_basic_stencil_variant.h"
+
+namespace platform {
+
+    namespace x86 {
+
+        // ij-blocked with lapij computing unroll-j rows per inner iteration: the unroll-j + 2 centre values of a
+        // column are loaded once and shared by the neighbouring rows, so lapij needs 3 * unroll-j + 2 instead of
+        // 5 * unroll-j loads; all other stencils are the same as in ij-blocked
+        template <class Platform, class ValueType>
+        class variant_ij_blocked_unrolled final : public x86_basic_stencil_variant<Platform, ValueType> {
+          public:
+            using value_type = ValueType;
+
+            variant_ij_blocked_unrolled(const arguments_map &args)
+                : x86_basic_stencil_variant<Platform, ValueType>(args), m_iblocksize(args.get<int>("i-blocksize")),
+                  m_jblocksize(args.get<int>("j-blocksize")), m_unroll(args.get<int>("unroll-j")) {
+                if (m_iblocksize <= 0 || m_jblocksize <= 0)
+                    throw ERROR("invalid block size");
+                if (m_unroll <= 0)
+                    throw ERROR("invalid unroll-j");
+            }
+
+            template <class Stencil>
+            void kernel() {
+                kernel(Stencil());
+            }
+
+          protected:
+            std::function<void()> stencil_function(const std::string &stencil) override {
+                return this->kernel_function(this, stencil, "x86/x86_variant_ij_blocked_unrolled.h");
+            }
+
+          private:
+            // static schedule hands out contiguous chunks of the collapsed (jb, ib) space,
+            // so neighbouring blocks (sharing halo lines) stay on the same core
+            template <class Stencil>
+            void kernel(Stencil) {
+                const value_type *__restrict__ src = this->src();
+                value_type *__restrict__ dst = this->dst();
+                const int isize = this->isize();
+                const int jsize = this->jsize();
+                const int ksize = this->ksize();
+                constexpr int istride = 1;
+                const int jstride = this->jstride();
+                const int kstride = this->kstride();
+                if (this->istride() != 1)
+                    throw ERROR("this variant is only compatible with unit i-stride layout");
+
+#pragma omp parallel for collapse(2) schedule(static)
+                for (int jb = 0; jb < jsize; jb += m_jblocksize) {
+                    for (int ib = 0; ib < isize; ib += m_iblocksize) {
+                        const int imax = ib + m_iblocksize <= isize ? ib + m_iblocksize : isize;
+                        const int jmax = jb + m_jblocksize <= jsize ? jb + m_jblocksize : jsize;
+
+                        for (int k = 0; k < ksize; ++k) {
+                            for (int j = jb; j < jmax; ++j) {
+                                const int row = j * jstride + k * kstride;
+#pragma omp simd
+                                for (int i = ib; i < imax; ++i) {
+                                    const int index = row + i * istride;
+                                    dst[index] = Stencil::eval(src + index, istride, jstride, kstride);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            // lapij with unroll-j rows per inner iteration
+            void kernel(basic_stencil::lapij) {
+                const value_type *__restrict__ src = this->src();
+                value_type *__restrict__ dst = this->dst();
+                const int isize = this->isize();
+                const int jsize = this->jsize();
+                const int ksize = this->ksize();
+                const int jstride = this->jstride();
+                const int kstride = this->kstride();
+                const int unroll = m_unroll;
+                if (this->istride() != 1)
+                    throw ERROR("this variant is only compatible with unit i-stride layout");
+
+#pragma omp parallel for collapse(2) schedule(static)
+                for (int jb = 0; jb < jsize; jb += m_jblocksize) {
+                    for (int ib = 0; ib < isize; ib += m_iblocksize) {
+                        const int imax = ib + m_iblocksize <= isize ? ib + m_iblocksize : isize;
+                        const int jmax = jb + m_jblocksize <= jsize ? jb + m_jblocksize : jsize;
+
+                        for (int k = 0; k < ksize; ++k) {
+                            int j = jb;
+                            // full groups of unroll rows, the remaining rows one by one
+                            for (; j + unroll <= jmax; j += unroll)
+                                lapij_rows(src, dst, j * jstride + k * kstride, ib, imax, jstride, unroll);
+                            for (; j < jmax; ++j)
+                                lapij_rows<1>(src, dst, j * jstride + k * kstride, ib, imax, jstride);
+                        }
+                    }
+                }
+            }
+
+            static void lapij_rows(const value_type *__restrict__ src,
+                value_type *__restrict__ dst,
+                int row,
+                const int ib,
+                const int imax,
+                const int jstride,
+                int unroll) {
+                // unroll values above 8 run as repeated groups of 8, the rest as groups of 4, 2 and 1
+                for (; unroll >= 8; unroll -= 8, row += 8 * jstride)
+                    lapij_rows<8>(src, dst, row, ib, imax, jstride);
+                if (unroll & 4) {
+                    lapij_rows<4>(src, dst, row, ib, imax, jstride);
+                    row += 4 * jstride;
+                }
+                if (unroll & 2) {
+                    lapij_rows<2>(src, dst, row, ib, imax, jstride);
+                    row += 2 * jstride;
+                }
+                if (unroll & 1)
+                    lapij_rows<1>(src, dst, row, ib, imax, jstride);
+            }
+
+            // lapij on rows row, row + jstride, ..., row + (UnrollJ - 1) * jstride
+            template <int UnrollJ>
+            static void lapij_rows(const value_type *__restrict__ src,
+                value_type *__restrict__ dst,
+                const int row,
+                const int ib,
+                const int imax,
+                const int jstride) {
+                constexpr int istride = 1;
+#pragma omp simd
+                for (int i = ib; i < imax; ++i) {
+                    const int index = row + i * istride;
+                    value_type c[UnrollJ + 2];
+                    for (int u = 0; u < UnrollJ + 2; ++u)
+                        c[u] = src[index + (u - 1) * jstride];
+                    for (int u = 0; u < UnrollJ; ++u) {
+                        const int n = index + u * jstride;
+                        dst[n] = c[u + 1] + src[n - istride] + src[n + istride] + c[u] + c[u + 2];
+                    }
+                }
+            }
+
+            int m_iblocksize, m_jblocksize, m_unroll;
+        };
+
+    } // namespace x86
+
+} // namespace platform
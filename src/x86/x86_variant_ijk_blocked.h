@@ -0,0 +1,70 @@
+#pragma once
+
+#include "x86/x86_basic_stencil_variant.h"
+
+namespace platform {
+
+    namespace x86 {
+
+        template <class Platform, class ValueType>
+        class variant_ijk_blocked final : public x86_basic_stencil_variant<Platform, ValueType> {
+          public:
+            using value_type = ValueType;
+
+            variant_ijk_blocked(const arguments_map &args)
+                : x86_basic_stencil_variant<Platform, ValueType>(args), m_iblocksize(args.get<int>("i-blocksize")),
+                  m_jblocksize(args.get<int>("j-blocksize")), m_kblocksize(args.get<int>("k-blocksize")) {
+                if (m_iblocksize <= 0 || m_jblocksize <= 0 || m_kblocksize <= 0)
+                    throw ERROR("invalid block size");
+            }
+
+            // static schedule hands out contiguous chunks of the collapsed (kb, jb, ib) space,
+            // so neighbouring blocks (sharing halo lines) stay on the same core
+            template <class Stencil>
+            void kernel() {
+                const value_type *__restrict__ src = this->src();
+                value_type *__restrict__ dst = this->dst();
+                const int isize = this->isize();
+                const int jsize = this->jsize();
+                const int ksize = this->ksize();
+                constexpr int istride = 1;
+                const int jstride = this->jstride();
+                const int kstride = this->kstride();
+                if (this->istride() != 1)
+                    throw ERROR("this variant is only compatible with unit i-stride layout");
+
+#pragma omp parallel for collapse(3) schedule(static)
+                for (int kb = 0; kb < ksize; kb += m_kblocksize) {
+                    for (int jb = 0; jb < jsize; jb += m_jblocksize) {
+                        for (int ib = 0; ib < isize; ib += m_iblocksize) {
+                            const int imax = ib + m_iblocksize <= isize ? ib + m_iblocksize : isize;
+                            const int jmax = jb + m_jblocksize <= jsize ? jb + m_jblocksize : jsize;
+                            const int kmax = kb + m_kblocksize <= ksize ? kb + m_kblocksize : ksize;
+
+                            for (int k = kb; k < kmax; ++k) {
+                                for (int j = jb; j < jmax; ++j) {
+                                    const int row = j * jstride + k * kstride;
+#pragma omp simd
+                                    for (int i = ib; i < imax; ++i) {
+                                        const int index = row + i * istride;
+                                        dst[index] = Stencil::eval(src + index, istride, jstride, kstride);
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+          protected:
+            std::function<void()> stencil_function(const std::string &stencil) override {
+                return this->kernel_function(this, stencil, "x86/x86_variant_ijk_blocked.h");
+            }
+
+          private:
+            int m_iblocksize, m_jblocksize, m_kblocksize;
+        };
+
+    } // namespace x86
+
+} // namespace platform